@@ -0,0 +1,74 @@
+// classes/sec: operator<< per class versus BatchCodeGenerator
+// usage: BatchCodeGeneratorBench [classes] [threads] [directory]
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "BatchCodeGenerator.cpp"
+
+using namespace std;
+
+template <typename Fn>
+double time_s(Fn&& fn)
+{
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 50000;
+    unsigned threads = argc > 2 ? unsigned(atoi(argv[2])) : thread::hardware_concurrency();
+    string dir = argc > 3 ? argv[3] : "/tmp/codebuilder_bench";
+    ::mkdir(dir.c_str(), 0755);
+
+    const char* types[] = {"int", "double", "string", "bool", "long", "float"};
+    vector<CodeBuilder> classes;
+    classes.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        CodeBuilder cb{"Generated" + to_string(i)};
+        for (size_t f = 0; f < 4 + i % 12; ++f)
+            cb.add_field("field_" + to_string(f), types[(i + f) % 6]);
+        classes.push_back(cb);
+    }
+
+    string streamed;
+    double stream_s = time_s([&] {
+        ostringstream os;
+        for (auto& cb : classes)
+            os << cb << "\n\n";
+        streamed = os.str();
+    });
+
+    BatchCodeGenerator generator(threads);
+    double batch_s = time_s([&] { generator.render(classes); });
+    bool same = generator.render(classes) == streamed;
+
+    size_t file_count = min<size_t>(count, 10000);
+    vector<CodeBuilder> some(classes.begin(), classes.begin() + ptrdiff_t(file_count));
+    double ofstream_s = time_s([&] {
+        for (auto& cb : some)
+        {
+            ofstream out(dir + "/" + cb.name() + ".hpp");
+            out << "#pragma once\n#include <string>\n\nusing namespace std;\n\n" << cb << "\n";
+        }
+    });
+    double writev_s = time_s([&] { generator.write_headers(some, dir); });
+
+    cout << count << " classes, " << threads << " threads, output " << streamed.size() / 1e6 << " MB"
+         << (same ? "" : " (OUTPUT DIFFERS)") << "\n";
+    cout << "render, operator<<        : " << double(count) / stream_s << " classes/s\n";
+    cout << "render, BatchCodeGenerator: " << double(count) / batch_s << " classes/s\n";
+    cout << "headers, ofstream         : " << double(file_count) / ofstream_s << " files/s\n";
+    cout << "headers, writev           : " << double(file_count) / writev_s << " files/s\n";
+    return same ? 0 : 1;
+}
@@ -1,3 +1,5 @@
+#pragma once
+#include <cstring>
 #include <string>
 #include <ostream>
 #include <vector>
@@ -21,6 +23,38 @@ public:
         return *this;
     }
 
+    const string& name() const { return class_name; }
+    const vector<pair<string, string>>& get_fields() const { return fields; }
+
+    // exact number of characters operator<< produces for this class
+    size_t rendered_size() const
+    {
+        size_t size = 6 + class_name.size() + 3;    // "class " name "\n{\n"
+        for (const auto& field : fields)
+            size += 2 + field.second.size() + 1 + field.first.size() + 2;
+        return size + 2;                            // "};"
+    }
+
+    // writes the same text as operator<< to out, which must hold
+    // rendered_size() characters; returns the end of what was written
+    char* render_to(char* out) const
+    {
+        auto put = [&out](const char* s, size_t n) { memcpy(out, s, n); out += n; };
+        put("class ", 6);
+        put(class_name.data(), class_name.size());
+        put("\n{\n", 3);
+        for (const auto& field : fields)
+        {
+            put("  ", 2);
+            put(field.second.data(), field.second.size());
+            put(" ", 1);
+            put(field.first.data(), field.first.size());
+            put(";\n", 2);
+        }
+        put("};", 2);
+        return out;
+    }
+
     friend ostream& operator<<(ostream& os, const CodeBuilder& obj)
     {
         os << "class " << obj.class_name << "\n{\n";
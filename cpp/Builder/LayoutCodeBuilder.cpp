@@ -0,0 +1,236 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "CodeBuilder.cpp"
+
+using namespace std;
+
+// Layout-aware emission for classes described by a CodeBuilder.
+// CodeBuilder writes fields in insertion order, which can leave a lot of
+// padding between them. LayoutCodeBuilder looks up the size and alignment
+// of every field type in a TypeRegistry, orders the fields by decreasing
+// alignment (hot fields first when requested), and can also emit an SoA
+// container for the class plus static_asserts that check the computed
+// size and alignment against the compiler.
+
+struct TypeLayout
+{
+    size_t size;
+    size_t align;
+};
+
+class TypeRegistry
+{
+public:
+    // primitive types with the sizes of the host this generator runs on
+    TypeRegistry()
+    {
+        add<bool>("bool");
+        add<char>("char");
+        add<short>("short");
+        add<int>("int");
+        add<long>("long");
+        add<long long>("long long");
+        add<unsigned>("unsigned");
+        add<float>("float");
+        add<double>("double");
+        add<int8_t>("int8_t");
+        add<uint8_t>("uint8_t");
+        add<int16_t>("int16_t");
+        add<uint16_t>("uint16_t");
+        add<int32_t>("int32_t");
+        add<uint32_t>("uint32_t");
+        add<int64_t>("int64_t");
+        add<uint64_t>("uint64_t");
+        add<size_t>("size_t");
+        add<string>("string");
+    }
+
+    TypeRegistry& register_type(const string& type, size_t size, size_t align)
+    {
+        if (align == 0 || (align & (align - 1)) != 0 || size % align != 0)
+            throw invalid_argument("bad layout for type " + type);
+        types[type] = {size, align};
+        return *this;
+    }
+
+    // pointers all share one layout
+    TypeLayout layout_of(const string& type) const
+    {
+        if (!type.empty() && type.back() == '*')
+            return {sizeof(void*), alignof(void*)};
+        auto it = types.find(type);
+        if (it == types.end())
+            throw invalid_argument("unknown field type " + type);
+        return it->second;
+    }
+
+private:
+    template <typename T>
+    void add(const string& type) { types[type] = {sizeof(T), alignof(T)}; }
+
+    map<string, TypeLayout> types;
+};
+
+struct LayoutReport
+{
+    string class_name;
+    size_t declared_size;      // fields in insertion order
+    size_t optimized_size;     // fields as emitted
+    size_t align;
+
+    // negative when hot fields cost more padding than reordering recovered
+    ptrdiff_t bytes_saved() const { return ptrdiff_t(declared_size) - ptrdiff_t(optimized_size); }
+};
+
+class LayoutCodeBuilder
+{
+public:
+    LayoutCodeBuilder(const CodeBuilder& source, const TypeRegistry& registry)
+        : class_name(source.name())
+    {
+        for (const auto& field : source.get_fields())
+            fields.push_back({field.first, field.second, registry.layout_of(field.second), false});
+    }
+
+    // hot fields are placed first so the ones used together share cache lines
+    LayoutCodeBuilder& hot(const string& field_name)
+    {
+        for (auto& field : fields)
+            if (field.name == field_name)
+            {
+                field.hot = true;
+                return *this;
+            }
+        throw invalid_argument("no field " + field_name + " in " + class_name);
+    }
+
+    LayoutCodeBuilder& with_static_asserts(bool enabled = true) { static_asserts = enabled; return *this; }
+
+    LayoutReport report() const
+    {
+        return {class_name, size_of(fields), size_of(ordered()), align_of(fields)};
+    }
+
+    // the class with its fields reordered, plus size/alignment checks
+    void emit_class(ostream& os) const
+    {
+        os << "class " << class_name << "\n{\npublic:\n";
+        for (const auto& field : ordered())
+            os << "  " << field.type << " " << field.name << ";\n";
+        os << "};";
+        if (static_asserts)
+        {
+            os << "\nstatic_assert(sizeof(" << class_name << ") == " << size_of(ordered())
+               << ", \"" << class_name << " size\");";
+            os << "\nstatic_assert(alignof(" << class_name << ") == " << align_of(fields)
+               << ", \"" << class_name << " alignment\");";
+        }
+    }
+
+    // one vector per field, hot fields first; needs <vector>
+    void emit_soa(ostream& os) const
+    {
+        auto order = ordered();
+        const string soa = class_name + "SoA";
+        os << "class " << soa << "\n{\npublic:\n";
+        for (const auto& field : order)
+            os << "  vector<" << field.type << "> " << field.name << ";\n";
+        // a class without fields has no column to count, so it stays empty
+        if (order.empty())
+        {
+            os << "  size_t size() const { return 0; }\n";
+            os << "  void push_back(const " << class_name << "&) {}\n";
+            os << "  " << class_name << " get(size_t) const { return " << class_name << "{}; }\n};";
+            return;
+        }
+        os << "\n  size_t size() const { return " << order.front().name << ".size(); }\n";
+        os << "  void push_back(const " << class_name << "& item)\n  {\n";
+        for (const auto& field : order)
+            os << "    " << field.name << ".push_back(item." << field.name << ");\n";
+        os << "  }\n";
+        os << "  " << class_name << " get(size_t i) const\n  {\n    " << class_name << " item;\n";
+        for (const auto& field : order)
+            os << "    item." << field.name << " = " << field.name << "[i];\n";
+        os << "    return item;\n  }\n};";
+    }
+
+    friend ostream& operator<<(ostream& os, const LayoutCodeBuilder& obj)
+    {
+        obj.emit_class(os);
+        return os;
+    }
+
+private:
+    struct Field
+    {
+        string name;
+        string type;
+        TypeLayout layout;
+        bool hot;
+    };
+
+    // hot group first, then by decreasing alignment; for power-of-two
+    // alignments this leaves padding only at group boundaries and the tail
+    vector<Field> ordered() const
+    {
+        vector<Field> order = fields;
+        stable_sort(order.begin(), order.end(), [](const Field& a, const Field& b) {
+            if (a.hot != b.hot)
+                return a.hot;
+            return a.layout.align > b.layout.align;
+        });
+        return order;
+    }
+
+    static size_t align_of(const vector<Field>& order)
+    {
+        size_t align = 1;
+        for (const auto& field : order)
+            align = max(align, field.layout.align);
+        return align;
+    }
+
+    // the same rules the compiler uses for a standard-layout class
+    static size_t size_of(const vector<Field>& order)
+    {
+        size_t offset = 0;
+        for (const auto& field : order)
+        {
+            offset = (offset + field.layout.align - 1) / field.layout.align * field.layout.align;
+            offset += field.layout.size;
+        }
+        size_t align = align_of(order);
+        return max<size_t>(1, (offset + align - 1) / align * align);
+    }
+
+    string class_name;
+    vector<Field> fields;
+    bool static_asserts = true;
+};
+
+/*
+int main()
+{
+    TypeRegistry types;
+    types.register_type("Vec3", 12, 4);
+
+    auto cb = CodeBuilder{"Particle"}.add_field("alive", "bool").add_field("mass", "double")
+                                     .add_field("id", "int").add_field("position", "Vec3");
+    LayoutCodeBuilder layout{cb, types};
+    layout.hot("position");
+
+    cout << layout << "\n";
+    layout.emit_soa(cout);
+    auto r = layout.report();
+    cout << "\n" << r.class_name << ": " << r.declared_size << " -> " << r.optimized_size << " bytes\n";
+}
+*/
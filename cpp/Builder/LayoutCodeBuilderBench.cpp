@@ -0,0 +1,77 @@
+// bytes saved by LayoutCodeBuilder over insertion-order layouts
+// usage: LayoutCodeBuilderBench [classes] [header-to-write]
+// when a header path is given, the first classes and their SoA variants
+// are written there so the static_asserts can be checked by a compiler
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "LayoutCodeBuilder.cpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+    const char* header = argc > 2 ? argv[2] : nullptr;
+
+    TypeRegistry types;
+    types.register_type("Vec3", 12, 4).register_type("Quat", 16, 16);
+    const char* type_names[] = {"bool", "char", "int16_t", "int", "float", "double",
+                                "int64_t", "string", "Vec3", "Quat", "void*"};
+
+    mt19937 rng(42);
+    vector<CodeBuilder> classes;
+    classes.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        CodeBuilder cb{"Generated" + to_string(i)};
+        size_t n = 2 + rng() % 12;
+        for (size_t f = 0; f < n; ++f)
+            cb.add_field("field_" + to_string(f), type_names[rng() % 11]);
+        classes.push_back(cb);
+    }
+
+    size_t declared = 0, optimized = 0, improved = 0, grown = 0;
+    ptrdiff_t best = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+    {
+        LayoutCodeBuilder layout{classes[i], types};
+        if (i % 4 == 0)
+            layout.hot("field_1");
+        auto r = layout.report();
+        declared += r.declared_size;
+        optimized += r.optimized_size;
+        improved += r.bytes_saved() > 0;
+        grown += r.bytes_saved() < 0;
+        best = max(best, r.bytes_saved());
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << count << " classes, " << double(count) / seconds << " layouts/s\n";
+    cout << "declared bytes : " << declared << "\n";
+    cout << "optimized bytes: " << optimized << " (" << 100.0 * double(declared - optimized) / double(declared)
+         << "% saved)\n";
+    cout << "classes shrunk : " << improved << ", largest saving " << best << " bytes\n";
+    cout << "classes grown  : " << grown << " (hot fields placed first)\n";
+
+    if (header)
+    {
+        ofstream out(header);
+        out << "#pragma once\n#include <cstdint>\n#include <string>\n#include <vector>\n\nusing namespace std;\n\n"
+            << "struct Vec3 { float x, y, z; };\nstruct alignas(16) Quat { float x, y, z, w; };\n\n";
+        for (size_t i = 0; i < min<size_t>(count, 200); ++i)
+        {
+            LayoutCodeBuilder layout{classes[i], types};
+            out << layout << "\n";
+            layout.emit_soa(out);
+            out << "\n\n";
+        }
+    }
+}
@@ -0,0 +1,122 @@
+// generated by SerializerCodeBuilder from the Order example in SerializerCodeBuilder.cpp
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+template <typename T>
+inline void wire_store(char* p, T value)
+{
+    memcpy(p, &value, sizeof(T));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    reverse(p, p + sizeof(T));
+#endif
+}
+
+template <typename T>
+inline T wire_load(const char* p)
+{
+    T value;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    char bytes[sizeof(T)];
+    reverse_copy(p, p + sizeof(T), bytes);
+    memcpy(&value, bytes, sizeof(T));
+#else
+    memcpy(&value, p, sizeof(T));
+#endif
+    return value;
+}
+
+// writes the string at base + tail and its offset/length into the slot
+inline void wire_store_string(char* slot, char* base, size_t& tail, const string& s)
+{
+    wire_store<uint32_t>(slot, uint32_t(tail));
+    wire_store<uint32_t>(slot + 4, uint32_t(s.size()));
+    memcpy(base + tail, s.data(), s.size());
+    tail += s.size();
+}
+
+inline string_view wire_load_string(const char* slot, const char* base)
+{
+    return {base + wire_load<uint32_t>(slot), wire_load<uint32_t>(slot + 4)};
+}
+
+inline bool wire_string_in_bounds(const char* slot, size_t size)
+{
+    return uint64_t(wire_load<uint32_t>(slot)) + wire_load<uint32_t>(slot + 4) <= size;
+}
+
+class Order
+{
+public:
+  int64_t id;
+  string customer;
+  int quantity;
+  double price;
+  bool express;
+  string note;
+  long long placed_at;
+};
+
+// Order on the wire: 45 fixed bytes, then string bytes
+inline size_t wire_size(const Order& v)
+{
+    return 45 + v.customer.size() + v.note.size();
+}
+
+// out must hold wire_size(v) bytes; returns the bytes written
+inline size_t encode(const Order& v, char* out)
+{
+    size_t tail = 45;
+    wire_store<int64_t>(out + 0, static_cast<int64_t>(v.id));
+    wire_store_string(out + 8, out, tail, v.customer);
+    wire_store<int32_t>(out + 16, static_cast<int32_t>(v.quantity));
+    wire_store<double>(out + 20, static_cast<double>(v.price));
+    wire_store<uint8_t>(out + 28, static_cast<uint8_t>(v.express));
+    wire_store_string(out + 29, out, tail, v.note);
+    wire_store<int64_t>(out + 37, static_cast<int64_t>(v.placed_at));
+    return tail;
+}
+
+inline void decode(const char* in, Order& v)
+{
+    v.id = static_cast<int64_t>(wire_load<int64_t>(in + 0));
+    v.customer.assign(wire_load_string(in + 8, in));
+    v.quantity = static_cast<int>(wire_load<int32_t>(in + 16));
+    v.price = static_cast<double>(wire_load<double>(in + 20));
+    v.express = wire_load<uint8_t>(in + 28) != 0;
+    v.note.assign(wire_load_string(in + 29, in));
+    v.placed_at = static_cast<long long>(wire_load<int64_t>(in + 37));
+}
+
+// true when size bytes at in hold a well-formed Order
+inline bool verify_Order(const char* in, size_t size)
+{
+    if (size < 45)
+        return false;
+    return true
+        && wire_string_in_bounds(in + 8, size)
+        && wire_string_in_bounds(in + 29, size);
+}
+
+// reads Order fields in place; the buffer must outlive the view
+class OrderView
+{
+public:
+    explicit OrderView(const char* data) : data(data) {}
+
+    int64_t id() const { return wire_load<int64_t>(data + 0); }
+    string_view customer() const { return wire_load_string(data + 8, data); }
+    int32_t quantity() const { return wire_load<int32_t>(data + 16); }
+    double price() const { return wire_load<double>(data + 20); }
+    bool express() const { return wire_load<uint8_t>(data + 28) != 0; }
+    string_view note() const { return wire_load_string(data + 29, data); }
+    int64_t placed_at() const { return wire_load<int64_t>(data + 37); }
+
+private:
+    const char* data;
+};
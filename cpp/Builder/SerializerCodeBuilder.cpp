@@ -0,0 +1,237 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "CodeBuilder.cpp"
+
+using namespace std;
+
+// Emits binary encode/decode code for a class described by a CodeBuilder.
+// The wire format is fixed-layout and little-endian: every field has a
+// slot at a constant offset, in declaration order, with no padding.
+// Strings take an 8-byte slot (uint32 offset, uint32 length) that points
+// into a tail after the fixed part, so a <Name>View can return any field
+// straight from the buffer, strings as string_view, without copying.
+//
+// Generated code needs emit_runtime() once per header, before any class.
+
+class SerializerCodeBuilder
+{
+public:
+    explicit SerializerCodeBuilder(const CodeBuilder& source) : class_name(source.name())
+    {
+        size_t offset = 0;
+        for (const auto& field : source.get_fields())
+        {
+            string wire = wire_type_of(field.second);
+            fields.push_back({field.first, field.second, wire, offset});
+            offset += wire == "string" ? 8 : wire_size_of(wire);
+        }
+        fixed_size = offset;
+    }
+
+    size_t fixed_wire_size() const { return fixed_size; }
+
+    // little-endian load/store helpers shared by every generated class
+    static void emit_runtime(ostream& os)
+    {
+        os << R"(#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+template <typename T>
+inline void wire_store(char* p, T value)
+{
+    memcpy(p, &value, sizeof(T));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    reverse(p, p + sizeof(T));
+#endif
+}
+
+template <typename T>
+inline T wire_load(const char* p)
+{
+    T value;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    char bytes[sizeof(T)];
+    reverse_copy(p, p + sizeof(T), bytes);
+    memcpy(&value, bytes, sizeof(T));
+#else
+    memcpy(&value, p, sizeof(T));
+#endif
+    return value;
+}
+
+// writes the string at base + tail and its offset/length into the slot
+inline void wire_store_string(char* slot, char* base, size_t& tail, const string& s)
+{
+    wire_store<uint32_t>(slot, uint32_t(tail));
+    wire_store<uint32_t>(slot + 4, uint32_t(s.size()));
+    memcpy(base + tail, s.data(), s.size());
+    tail += s.size();
+}
+
+inline string_view wire_load_string(const char* slot, const char* base)
+{
+    return {base + wire_load<uint32_t>(slot), wire_load<uint32_t>(slot + 4)};
+}
+
+inline bool wire_string_in_bounds(const char* slot, size_t size)
+{
+    return uint64_t(wire_load<uint32_t>(slot)) + wire_load<uint32_t>(slot + 4) <= size;
+}
+)";
+    }
+
+    // the class with public fields, followed by its serializer and view
+    void emit(ostream& os) const
+    {
+        os << "class " << class_name << "\n{\npublic:\n";
+        for (const auto& f : fields)
+            os << "  " << f.type << " " << f.name << ";\n";
+        os << "};\n\n";
+        emit_functions(os);
+        os << "\n";
+        emit_view(os);
+    }
+
+    friend ostream& operator<<(ostream& os, const SerializerCodeBuilder& obj)
+    {
+        obj.emit(os);
+        return os;
+    }
+
+private:
+    struct Field
+    {
+        string name;
+        string type;
+        string wire;
+        size_t offset;
+    };
+
+    static string wire_type_of(const string& type)
+    {
+        static const map<string, string> wire_types = {
+            {"bool", "bool"},       {"char", "int8_t"},      {"int8_t", "int8_t"},     {"uint8_t", "uint8_t"},
+            {"short", "int16_t"},   {"int16_t", "int16_t"},  {"uint16_t", "uint16_t"}, {"int", "int32_t"},
+            {"int32_t", "int32_t"}, {"unsigned", "uint32_t"}, {"uint32_t", "uint32_t"}, {"long", "int64_t"},
+            {"long long", "int64_t"}, {"int64_t", "int64_t"}, {"uint64_t", "uint64_t"}, {"size_t", "uint64_t"},
+            {"float", "float"},     {"double", "double"},    {"string", "string"},
+        };
+        auto it = wire_types.find(type);
+        if (it == wire_types.end())
+            throw invalid_argument("no wire encoding for field type " + type);
+        return it->second;
+    }
+
+    static size_t wire_size_of(const string& wire)
+    {
+        if (wire == "bool" || wire == "int8_t" || wire == "uint8_t")
+            return 1;
+        if (wire == "int16_t" || wire == "uint16_t")
+            return 2;
+        if (wire == "int32_t" || wire == "uint32_t" || wire == "float")
+            return 4;
+        return 8;
+    }
+
+    // bools travel as one byte
+    static string stored_type(const Field& f) { return f.wire == "bool" ? "uint8_t" : f.wire; }
+
+    void emit_functions(ostream& os) const
+    {
+        const string& n = class_name;
+        os << "// " << n << " on the wire: " << fixed_size << " fixed bytes, then string bytes\n";
+        os << "inline size_t wire_size(const " << n << "& v)\n{\n    return " << fixed_size;
+        for (const auto& f : fields)
+            if (f.wire == "string")
+                os << " + v." << f.name << ".size()";
+        os << ";\n}\n\n";
+
+        os << "// out must hold wire_size(v) bytes; returns the bytes written\n";
+        os << "inline size_t encode(const " << n << "& v, char* out)\n{\n    size_t tail = " << fixed_size << ";\n";
+        for (const auto& f : fields)
+        {
+            if (f.wire == "string")
+                os << "    wire_store_string(out + " << f.offset << ", out, tail, v." << f.name << ");\n";
+            else
+                os << "    wire_store<" << stored_type(f) << ">(out + " << f.offset << ", static_cast<"
+                   << stored_type(f) << ">(v." << f.name << "));\n";
+        }
+        os << "    return tail;\n}\n\n";
+
+        os << "inline void decode(const char* in, " << n << "& v)\n{\n";
+        for (const auto& f : fields)
+        {
+            // assign keeps the capacity of strings in a reused object
+            if (f.wire == "string")
+            {
+                os << "    v." << f.name << ".assign(wire_load_string(in + " << f.offset << ", in));\n";
+                continue;
+            }
+            os << "    v." << f.name << " = ";
+            if (f.wire == "bool")
+                os << "wire_load<uint8_t>(in + " << f.offset << ") != 0;\n";
+            else
+                // a functional cast would not parse for multi-word types such as long long
+                os << "static_cast<" << f.type << ">(wire_load<" << f.wire << ">(in + " << f.offset << "));\n";
+        }
+        os << "}\n\n";
+
+        os << "// true when size bytes at in hold a well-formed " << n << "\n";
+        os << "inline bool verify_" << n << "(const char* in, size_t size)\n{\n";
+        os << "    if (size < " << fixed_size << ")\n        return false;\n";
+        os << "    return true";
+        for (const auto& f : fields)
+            if (f.wire == "string")
+                os << "\n        && wire_string_in_bounds(in + " << f.offset << ", size)";
+        os << ";\n}\n";
+    }
+
+    void emit_view(ostream& os) const
+    {
+        os << "// reads " << class_name << " fields in place; the buffer must outlive the view\n";
+        os << "class " << class_name << "View\n{\npublic:\n";
+        os << "    explicit " << class_name << "View(const char* data) : data(data) {}\n\n";
+        for (const auto& f : fields)
+        {
+            if (f.wire == "string")
+                os << "    string_view " << f.name << "() const { return wire_load_string(data + " << f.offset
+                   << ", data); }\n";
+            else if (f.wire == "bool")
+                os << "    bool " << f.name << "() const { return wire_load<uint8_t>(data + " << f.offset
+                   << ") != 0; }\n";
+            else
+                os << "    " << f.wire << " " << f.name << "() const { return wire_load<" << f.wire
+                   << ">(data + " << f.offset << "); }\n";
+        }
+        os << "\nprivate:\n    const char* data;\n};\n";
+    }
+
+    string class_name;
+    vector<Field> fields;
+    size_t fixed_size;
+};
+
+/*
+int main()
+{
+    auto order = CodeBuilder{"Order"}.add_field("id", "int64_t").add_field("customer", "string")
+                                     .add_field("quantity", "int").add_field("price", "double")
+                                     .add_field("express", "bool").add_field("note", "string")
+                                     .add_field("placed_at", "long long");
+    ofstream out("OrderWire.generated.hpp");
+    out << "#pragma once\n";
+    SerializerCodeBuilder::emit_runtime(out);
+    out << "\n" << SerializerCodeBuilder{order};
+}
+*/
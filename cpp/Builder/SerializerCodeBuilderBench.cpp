@@ -0,0 +1,102 @@
+// round trip of generated binary serializers versus iostream text
+// usage: SerializerCodeBuilderBench [records]
+// OrderWire.generated.hpp comes from SerializerCodeBuilder (see the
+// commented main there); regenerate it after changing the Order fields
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "OrderWire.generated.hpp"
+
+using namespace std;
+
+template <typename Fn>
+double time_s(Fn&& fn)
+{
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+bool same(const Order& a, const Order& b)
+{
+    return a.id == b.id && a.customer == b.customer && a.quantity == b.quantity && a.price == b.price &&
+           a.express == b.express && a.note == b.note && a.placed_at == b.placed_at;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+    vector<Order> orders(count);
+    for (size_t i = 0; i < count; ++i)
+        orders[i] = {int64_t(i) * 7919, "customer_" + to_string(i % 5000), int(i % 100), 0.25 * double(i % 4000),
+                     i % 3 == 0, "note_" + to_string(i), 1700000000000LL + static_cast<long long>(i)};
+
+    // binary: records back to back, with their offsets
+    vector<char> wire;
+    vector<size_t> offsets(count);
+    vector<Order> decoded(count);
+    double encode_s = time_s([&] {
+        size_t total = 0;
+        for (auto& o : orders)
+            total += wire_size(o);
+        wire.resize(total);
+        size_t at = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            offsets[i] = at;
+            at += encode(orders[i], wire.data() + at);
+        }
+    });
+    double decode_s = time_s([&] {
+        for (size_t i = 0; i < count; ++i)
+            decode(wire.data() + offsets[i], decoded[i]);
+    });
+    double view_total = 0;
+    double view_s = time_s([&] {
+        for (size_t i = 0; i < count; ++i)
+        {
+            OrderView view(wire.data() + offsets[i]);
+            view_total += view.price() * view.quantity();
+        }
+    });
+    bool binary_ok = true;
+    for (size_t i = 0; i < count; ++i)
+        binary_ok &= same(orders[i], decoded[i]) &&
+                     verify_Order(wire.data() + offsets[i], (i + 1 < count ? offsets[i + 1] : wire.size()) - offsets[i]);
+
+    // text: one whitespace-separated line per record
+    string text;
+    double text_encode_s = time_s([&] {
+        ostringstream os;
+        os.precision(17);
+        for (auto& o : orders)
+            os << o.id << ' ' << o.customer << ' ' << o.quantity << ' ' << o.price << ' ' << o.express << ' '
+               << o.note << ' ' << o.placed_at << '\n';
+        text = os.str();
+    });
+    vector<Order> parsed(count);
+    double text_decode_s = time_s([&] {
+        istringstream is(text);
+        for (auto& o : parsed)
+            is >> o.id >> o.customer >> o.quantity >> o.price >> o.express >> o.note >> o.placed_at;
+    });
+    bool text_ok = true;
+    for (size_t i = 0; i < count; ++i)
+        text_ok &= same(orders[i], parsed[i]);
+
+    auto rate = [count](double s) { return double(count) / s / 1e6; };
+    cout << count << " orders\n";
+    cout << "binary: " << wire.size() / 1e6 << " MB, encode " << rate(encode_s) << " M/s, decode "
+         << rate(decode_s) << " M/s, view " << rate(view_s) << " M/s" << (binary_ok ? "" : " (MISMATCH)") << "\n";
+    cout << "text  : " << text.size() / 1e6 << " MB, encode " << rate(text_encode_s) << " M/s, decode "
+         << rate(text_decode_s) << " M/s" << (text_ok ? "" : " (MISMATCH)") << "\n";
+    cout << "round trip speedup: " << (text_encode_s + text_decode_s) / (encode_s + decode_s) << "x"
+         << " (checksum " << view_total << ")\n";
+    return binary_ok && text_ok ? 0 : 1;
+}
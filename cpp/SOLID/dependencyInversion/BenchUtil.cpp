@@ -0,0 +1,50 @@
+#pragma once
+/**
+ * @file BenchUtil.cpp
+ * @brief Small timing helpers shared by the mission benchmarks.
+ *
+ * The unit classes report every action on std::cout, so a benchmark that
+ * times them as-is mostly measures the terminal. SilenceCout swaps the
+ * stream buffer for one that drops everything while a benchmark runs.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <streambuf>
+
+// Stream buffer that accepts and discards all output
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// RAII guard: std::cout writes go nowhere until the guard is destroyed
+class SilenceCout {
+public:
+    SilenceCout() : m_saved(std::cout.rdbuf(&m_null)) {}
+    ~SilenceCout() { std::cout.rdbuf(m_saved); }
+
+    SilenceCout(const SilenceCout&) = delete;
+    SilenceCout& operator=(const SilenceCout&) = delete;
+
+private:
+    NullBuffer m_null;
+    std::streambuf* m_saved;
+};
+
+// Wall-clock time of one call to fn, in nanoseconds
+template <typename Fn>
+double timeNs(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+// Prints one benchmark line as total time and time per item
+inline void reportNs(const char* label, double totalNs, std::size_t items, const char* item = "unit") {
+    std::cout << label << ": " << totalNs / 1e6 << " ms, "
+              << totalNs / static_cast<double>(items) << " ns/" << item << std::endl;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file EventLogBench.cpp
+ * @brief Mission throughput with each EventSink, against the old per-line flush.
+ *
+ * Usage: EventLogBench [units] [ticks] [output file]
+ * Output goes to /dev/null by default so the terminal is not measured.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "BenchUtil.cpp"
+#include "ResourceMgmtUnitTemplate.cpp"
+
+static std::vector<std::unique_ptr<Unit<int>>> makeSquad(std::size_t unitCount, EventSink& events) {
+    std::vector<std::unique_ptr<Unit<int>>> squad;
+    squad.reserve(unitCount);
+    for (std::size_t i = 0; i < unitCount; ++i) {
+        std::string name = "Unit " + std::to_string(i);
+        switch (i % 3) {
+            case 0:  squad.push_back(std::make_unique<Marine<int>>(name, 100, 30, events)); break;
+            case 1:  squad.push_back(std::make_unique<Medic<int>>(name, 80, 5, events)); break;
+            default: squad.push_back(std::make_unique<Engineer<int>>(name, 90, 10, events)); break;
+        }
+    }
+    return squad;
+}
+
+template <typename Sink>
+static double runMission(std::size_t unitCount, int ticks, Sink& sink) {
+    auto squad = makeSquad(unitCount, sink);
+    std::vector<Unit<int>*> units;
+    for (auto& u : squad) units.push_back(u.get());
+    return timeNs([&] {
+        for (int t = 0; t < ticks; ++t) performMission(units, 50);
+        if constexpr (std::is_same_v<Sink, AsyncEventLog>) sink.flush();
+    });
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t unitCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const int ticks = argc > 2 ? std::atoi(argv[2]) : 5;
+    std::ofstream out(argc > 3 ? argv[3] : "/dev/null");
+
+    StreamEventSink flushed(out, true);
+    StreamEventSink buffered(out, false);
+    AsyncEventLog async(out);
+    NullEventSink quiet;
+
+    const std::size_t events = unitCount * ticks * 2;
+    std::cout << unitCount << " units, " << ticks << " ticks, " << events << " events" << std::endl;
+    reportNs("stream, flush per event", runMission(unitCount, ticks, flushed), events, "event");
+    reportNs("stream, buffered       ", runMission(unitCount, ticks, buffered), events, "event");
+    reportNs("async ring log         ", runMission(unitCount, ticks, async), events, "event");
+    reportNs("quiet                  ", runMission(unitCount, ticks, quiet), events, "event");
+    return 0;
+}
@@ -0,0 +1,118 @@
+#pragma once
+/**
+ * @file MissionArena.cpp
+ * @brief Per-mission arena that owns unit objects.
+ *
+ * Phase 5: Mission-scoped allocation
+ * The mission examples create each unit with its own new and tear the squad
+ * down with a delete loop. MissionArena carves units out of large blocks
+ * instead. Pointers it hands out stay valid until release(), which ends the
+ * whole mission at once: destructors run newest-first, and the blocks are
+ * rewound for the next mission rather than returned to the global allocator.
+ * Trivially destructible objects skip the destructor list entirely.
+ *
+ * Works with any of the Unit hierarchies (Unit.cpp, UnitTemplate.cpp,
+ * ResourceMgmtUnitTemplate.cpp); it only needs the concrete type to create.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class MissionArena {
+public:
+    explicit MissionArena(std::size_t blockSize = 64 * 1024) : m_blockSize(blockSize) {}
+
+    ~MissionArena() { release(); }
+
+    MissionArena(const MissionArena&) = delete;
+    MissionArena& operator=(const MissionArena&) = delete;
+
+    // Constructs a U inside the arena; the arena owns it until release()
+    template <typename U, typename... Args>
+    U* create(Args&&... args) {
+        if constexpr (std::is_trivially_destructible_v<U>) {
+            return new (allocate(sizeof(U), alignof(U))) U(std::forward<Args>(args)...);
+        } else {
+            auto* record = static_cast<DestructorRecord*>(
+                    allocate(sizeof(DestructorRecord), alignof(DestructorRecord)));
+            U* object = new (allocate(sizeof(U), alignof(U))) U(std::forward<Args>(args)...);
+            record->destroy = [](void* p) { static_cast<U*>(p)->~U(); };
+            record->object = object;
+            record->next = m_destructors;
+            m_destructors = record;
+            return object;
+        }
+    }
+
+    // Ends the mission: destroys every object and rewinds to the first block.
+    // Blocks are kept, so the next mission allocates nothing from the heap.
+    void release() {
+        for (DestructorRecord* r = m_destructors; r != nullptr; r = r->next)
+            r->destroy(r->object);
+        m_destructors = nullptr;
+        m_current = 0;
+        m_offset = 0;
+    }
+
+    std::size_t blockCount() const { return m_blocks.size(); }
+
+private:
+    struct DestructorRecord {
+        void (*destroy)(void*);
+        void* object;
+        DestructorRecord* next;
+    };
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size;
+    };
+
+    void* allocate(std::size_t size, std::size_t align) {
+        while (m_current < m_blocks.size()) {
+            if (void* p = carve(m_blocks[m_current], size, align)) return p;
+            ++m_current;
+            m_offset = 0;
+        }
+        std::size_t blockSize = size + align > m_blockSize ? size + align : m_blockSize;
+        m_blocks.push_back({std::make_unique<std::byte[]>(blockSize), blockSize});
+        m_current = m_blocks.size() - 1;
+        m_offset = 0;
+        return carve(m_blocks[m_current], size, align);
+    }
+
+    void* carve(Block& block, std::size_t size, std::size_t align) {
+        auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+        std::uintptr_t start = (base + m_offset + align - 1) & ~(std::uintptr_t(align) - 1);
+        if (start + size > base + block.size) return nullptr;
+        m_offset = start + size - base;
+        return reinterpret_cast<void*>(start);
+    }
+
+    std::vector<Block> m_blocks;
+    std::size_t m_current = 0;
+    std::size_t m_offset = 0;
+    std::size_t m_blockSize;
+    DestructorRecord* m_destructors = nullptr;
+};
+
+/*
+ * int main() {
+    MissionArena arena;
+    std::vector<Unit<int>*> units;
+    units.push_back(arena.create<Marine<int>>("John Doe", 100, 30));
+    units.push_back(arena.create<Medic<int>>("Jane Smith", 80, 5));
+    units.push_back(arena.create<Engineer<int>>("Bob Builder", 90, 10));
+
+    performMission(units, 50);
+
+    // No delete loop: the arena ends the mission
+    arena.release();
+    return 0;
+}
+ */
@@ -0,0 +1,89 @@
+/**
+ * @file MissionArenaBench.cpp
+ * @brief Heap allocations and spawn/despawn latency: new/delete vs MissionArena.
+ *
+ * Usage: MissionArenaBench [units] [missions]
+ * Global operator new is replaced here only to count calls. Units report to a
+ * NullEventSink, which keeps no names, so what is left per unit is building
+ * its callsign.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "MissionArena.cpp"
+#include "BenchUtil.cpp"
+#include "ResourceMgmtUnitTemplate.cpp"
+
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Names long enough to defeat the small-string buffer, as real callsigns would
+static std::string callsign(std::size_t i) {
+    return "Second Platoon Callsign " + std::to_string(i);
+}
+
+template <typename Spawn>
+static void spawnSquad(std::vector<Unit<int>*>& units, std::size_t count, EventSink& events, Spawn&& spawn) {
+    for (std::size_t i = 0; i < count; ++i) {
+        switch (i % 3) {
+            case 0:  units.push_back(spawn(Marine<int>(callsign(i), 100, 30, events))); break;
+            case 1:  units.push_back(spawn(Medic<int>(callsign(i), 80, 5, events))); break;
+            default: units.push_back(spawn(Engineer<int>(callsign(i), 90, 10, events))); break;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t unitCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const int missions = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    NullEventSink quiet;
+    std::vector<Unit<int>*> units;
+    units.reserve(unitCount);
+
+    std::size_t heapAllocs = g_allocations;
+    double heapNs = timeNs([&] {
+        for (int m = 0; m < missions; ++m) {
+            spawnSquad(units, unitCount, quiet, [](auto&& u) -> Unit<int>* {
+                return new std::decay_t<decltype(u)>(std::move(u));
+            });
+            for (auto unit : units) delete unit;
+            units.clear();
+        }
+    });
+    heapAllocs = g_allocations - heapAllocs;
+
+    MissionArena arena(1 << 20);
+    std::size_t arenaAllocs = g_allocations;
+    double arenaNs = timeNs([&] {
+        for (int m = 0; m < missions; ++m) {
+            spawnSquad(units, unitCount, quiet, [&](auto&& u) -> Unit<int>* {
+                return arena.create<std::decay_t<decltype(u)>>(std::move(u));
+            });
+            arena.release();
+            units.clear();
+        }
+    });
+    arenaAllocs = g_allocations - arenaAllocs;
+
+    const std::size_t spawned = unitCount * missions;
+    std::cout << unitCount << " units, " << missions << " missions" << std::endl;
+    std::cout << "new/delete:   " << heapAllocs << " allocations" << std::endl;
+    reportNs("new/delete  ", heapNs, spawned);
+    std::cout << "MissionArena: " << arenaAllocs << " allocations, "
+              << arena.blockCount() << " blocks" << std::endl;
+    reportNs("MissionArena", arenaNs, spawned);
+    return 0;
+}
@@ -0,0 +1,349 @@
+#pragma once
+/**
+ * @file MissionEvents.cpp
+ * @brief Event sink abstraction the units report their actions through.
+ *
+ * Units used to write straight to std::cout with std::endl, so every action
+ * cost a format, a flush and a syscall. They now record a small binary
+ * MissionEvent into an EventSink, in the same way performMission depends on
+ * Unit<T> rather than on Marine: the unit no longer knows where its output
+ * goes.
+ *
+ *   - StreamEventSink formats each event immediately (the old behaviour).
+ *   - AsyncEventLog queues events in per-thread lock-free rings; a background
+ *     thread formats and writes them in large batches.
+ *   - NullEventSink discards everything (quiet mode).
+ *
+ * Names are not copied into events; events carry the unit's id. A unit hands
+ * its name to its sink once, when it is created. Sinks that print keep the
+ * names in their own UnitDirectory and drop each one when its unit is
+ * destroyed, so nothing accumulates across missions. Quiet sinks keep none.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Retired is internal to AsyncEventLog: it marks where a unit's events end
+enum class EventKind : std::uint8_t { Moved, UsedResource, OutOfResource, Resupplied, Retired };
+
+// 16-byte record of one unit action
+struct MissionEvent {
+    std::uint32_t unitId;
+    std::uint16_t resourceId;
+    EventKind kind;
+    double value;  // distance for Moved, amount left for UsedResource, amount received for Resupplied
+};
+
+// Ids of units and pools: a lock-free counter, so creating a unit takes no lock
+constexpr std::uint32_t kNoUnitId = 0xFFFFFFFFu;
+
+inline std::uint32_t nextUnitId() {
+    static std::atomic<std::uint32_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Resource names ("ammo", "medkit", ...), shared by every sink. There are only
+// a handful, so the table never needs cleaning up; each thread caches the ids
+// it has looked up and takes the lock only for a name it has not seen.
+class ResourceNames {
+public:
+    static std::uint16_t idOf(const std::string& name) {
+        thread_local std::vector<std::pair<std::string, std::uint16_t>> cache;
+        for (auto& entry : cache)
+            if (entry.first == name) return entry.second;
+        ResourceNames& table = instance();
+        std::lock_guard<std::mutex> lock(table.m_mutex);
+        auto it = std::find(table.m_names.begin(), table.m_names.end(), name);
+        if (it == table.m_names.end()) it = table.m_names.insert(it, name);
+        auto id = static_cast<std::uint16_t>(it - table.m_names.begin());
+        cache.emplace_back(name, id);
+        return id;
+    }
+
+    // deque never moves existing elements, so the reference outlives the lock
+    static const std::string& name(std::uint16_t id) {
+        ResourceNames& table = instance();
+        std::lock_guard<std::mutex> lock(table.m_mutex);
+        return table.m_names[id];
+    }
+
+private:
+    static ResourceNames& instance() {
+        static ResourceNames table;
+        return table;
+    }
+
+    std::mutex m_mutex;
+    std::deque<std::string> m_names;
+};
+
+// Names of the units reporting to one sink. A sink that formats events keeps
+// one; entries are added when a unit is created and removed when it is gone.
+class UnitDirectory {
+public:
+    void addUnit(std::uint32_t id, const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_units[id] = name;
+    }
+
+    void removeUnit(std::uint32_t id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_units.erase(id);
+    }
+
+    // Valid until the unit is removed. An unknown id reads as "unit #id",
+    // valid until the next unknown id is looked up on this thread.
+    const std::string& unitName(std::uint32_t id) const {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_units.find(id);
+            if (it != m_units.end()) return it->second;
+        }
+        thread_local std::string unknown;
+        unknown = "unit #" + std::to_string(id);
+        return unknown;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::uint32_t, std::string> m_units;
+};
+
+// Renders an event as the line the units used to print
+inline void formatEvent(std::ostream& os, const MissionEvent& event, const UnitDirectory& units) {
+    const std::string& name = units.unitName(event.unitId);
+    switch (event.kind) {
+        case EventKind::Moved:
+            os << name << " moved " << event.value << " meters.\n";
+            break;
+        case EventKind::UsedResource: {
+            const std::string& resource = ResourceNames::name(event.resourceId);
+            os << name << " used a " << resource << ". " << resource << " left: " << event.value << '\n';
+            break;
+        }
+        case EventKind::OutOfResource:
+            os << name << " is out of " << ResourceNames::name(event.resourceId) << "!\n";
+            break;
+        case EventKind::Resupplied:
+            os << name << " resupplied with " << event.value << ' ' << ResourceNames::name(event.resourceId)
+               << ".\n";
+            break;
+        case EventKind::Retired:
+            break;
+    }
+}
+
+// Units call nameUnit when created and retireUnit when destroyed, so a sink
+// must outlive the units that report to it. Sinks that never print names
+// keep the defaults and store nothing.
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+    virtual void record(const MissionEvent& event) = 0;
+    virtual void nameUnit(std::uint32_t, const std::string&) {}
+    virtual void retireUnit(std::uint32_t) {}
+};
+
+// Quiet mode: events are dropped
+class NullEventSink : public EventSink {
+public:
+    void record(const MissionEvent&) override {}
+};
+
+// Formats each event on the calling thread as soon as it is recorded
+class StreamEventSink : public EventSink {
+public:
+    explicit StreamEventSink(std::ostream& os, bool flushEachEvent = true)
+            : m_os(os), m_flushEachEvent(flushEachEvent) {}
+
+    void record(const MissionEvent& event) override {
+        // One write per line keeps lines whole when units run on several threads
+        std::ostringstream line;
+        formatEvent(line, event, m_units);
+        m_os << line.str();
+        if (m_flushEachEvent) m_os.flush();
+    }
+
+    void nameUnit(std::uint32_t id, const std::string& name) override { m_units.addUnit(id, name); }
+    void retireUnit(std::uint32_t id) override { m_units.removeUnit(id); }
+
+private:
+    std::ostream& m_os;
+    bool m_flushEachEvent;
+    UnitDirectory m_units;
+};
+
+// Fixed-capacity single-producer/single-consumer queue
+class EventRing {
+public:
+    explicit EventRing(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) size <<= 1;
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    bool tryPush(const MissionEvent& event) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_slots.size()) return false;
+        m_slots[tail & m_mask] = event;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Hands every queued event to fn and returns how many there were
+    template <typename Fn>
+    std::size_t drain(Fn&& fn) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        for (std::size_t i = head; i != tail; ++i) fn(m_slots[i & m_mask]);
+        m_head.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+
+private:
+    std::vector<MissionEvent> m_slots;
+    std::size_t m_mask = 0;
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+};
+
+// Producers push into a ring owned by their thread; a background thread
+// formats the rings into os. A producer that fills its ring waits for it to
+// drain rather than dropping events.
+class AsyncEventLog : public EventSink {
+public:
+    explicit AsyncEventLog(std::ostream& os, std::size_t ringCapacity = 1 << 14)
+            : m_os(os), m_ringCapacity(ringCapacity), m_id(nextLogId()),
+              m_drainer([this] { drainLoop(); }) {}
+
+    ~AsyncEventLog() override {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_drainer.join();
+        flush();
+    }
+
+    AsyncEventLog(const AsyncEventLog&) = delete;
+    AsyncEventLog& operator=(const AsyncEventLog&) = delete;
+
+    void record(const MissionEvent& event) override {
+        EventRing& ring = localRing();
+        while (!ring.tryPush(event)) {
+            m_wake.notify_one();
+            std::this_thread::yield();
+        }
+    }
+
+    void nameUnit(std::uint32_t id, const std::string& name) override { m_units.addUnit(id, name); }
+
+    // The name is dropped once the drain thread is past the unit's last events
+    void retireUnit(std::uint32_t id) override { record({id, 0, EventKind::Retired, 0}); }
+
+    // Writes out everything recorded so far by threads that have returned
+    // from record()
+    void flush() {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        drainOnce();
+        m_os.flush();
+    }
+
+private:
+    static std::uint64_t nextLogId() {
+        static std::atomic<std::uint64_t> next{1};
+        return next.fetch_add(1);
+    }
+
+    EventRing& localRing() {
+        // Logs are told apart by id, not address, so a new log at a recycled
+        // address never picks up a stale ring
+        thread_local std::vector<std::pair<std::uint64_t, EventRing*>> cache;
+        for (auto& entry : cache)
+            if (entry.first == m_id) return *entry.second;
+
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        m_rings.push_back(std::make_unique<EventRing>(m_ringCapacity));
+        cache.emplace_back(m_id, m_rings.back().get());
+        return *m_rings.back();
+    }
+
+    // Caller holds m_drainMutex
+    std::size_t drainOnce() {
+        std::vector<EventRing*> rings;
+        {
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            for (auto& ring : m_rings) rings.push_back(ring.get());
+        }
+        std::size_t drained = 0;
+        std::vector<std::uint32_t> retired;
+        for (EventRing* ring : rings)
+            drained += ring->drain([&](const MissionEvent& e) {
+                if (e.kind == EventKind::Retired)
+                    retired.push_back(e.unitId);
+                else
+                    formatEvent(m_buffer, e, m_units);
+            });
+        // A unit's last events may sit in a ring this pass read before the one
+        // holding its Retired marker; they are visible by the next pass, so
+        // names are removed one pass late
+        for (std::uint32_t id : m_retiring) m_units.removeUnit(id);
+        m_retiring.swap(retired);
+        if (drained > 0) {
+            const std::string text = m_buffer.str();
+            m_os.write(text.data(), static_cast<std::streamsize>(text.size()));
+            m_buffer.str(std::string());
+        }
+        return drained;
+    }
+
+    void drainLoop() {
+        std::unique_lock<std::mutex> wakeLock(m_wakeMutex);
+        while (!m_stop) {
+            wakeLock.unlock();
+            {
+                std::lock_guard<std::mutex> lock(m_drainMutex);
+                drainOnce();
+            }
+            wakeLock.lock();
+            m_wake.wait_for(wakeLock, std::chrono::milliseconds(1));
+        }
+    }
+
+    std::ostream& m_os;
+    std::size_t m_ringCapacity;
+    std::uint64_t m_id;
+    std::ostringstream m_buffer;
+    UnitDirectory m_units;
+    std::vector<std::uint32_t> m_retiring;
+    std::mutex m_ringsMutex;
+    std::vector<std::unique_ptr<EventRing>> m_rings;
+    std::mutex m_drainMutex;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+    std::thread m_drainer;
+};
+
+// Sink used by units that are not given one: std::cout, flushed per event
+inline EventSink& defaultEventSink() {
+    static StreamEventSink sink(std::cout);
+    return sink;
+}
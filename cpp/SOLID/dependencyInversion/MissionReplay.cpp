@@ -0,0 +1,306 @@
+#pragma once
+/**
+ * @file MissionReplay.cpp
+ * @brief Deterministic record and replay of mission commands with per-tick state hashes.
+ *
+ * Phase 12: Record and replay
+ * MissionRecorder saves the starting state with saveMission and then executes
+ * and logs every move/action command issued to the units. At the end of each
+ * tick it hashes the state of every unit and pool into the log. Commands are
+ * a one-byte opcode and a varint delta to the previous unit index, plus the
+ * raw distance for a move. A tick of performMission therefore costs two bytes
+ * per action, and the log is buffered in memory and written in large chunks.
+ *
+ * MissionReplayer restores the snapshot, maps the log and issues the same
+ * calls in the same order on the restored units. It recomputes each tick hash
+ * and reports the first tick that differs. A behaviour change in Unit<T> or
+ * ResourceManager shows up as a hash mismatch instead of a silent diff.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MissionSnapshot.cpp"
+
+constexpr std::uint32_t kReplayLogVersion = 1;
+
+enum class ReplayOp : std::uint8_t { Move = 1, Action = 2, EndTick = 3 };
+
+struct ReplayLogHeader {
+    char magic[4];              // "MREC"
+    std::uint32_t version;
+    std::uint16_t valueSize;
+    std::uint16_t valueIsFloat;
+    std::uint32_t unitCount;
+};
+
+// Hashes health, resources and position of every unit and the stock of every
+// pool. Pools are hashed in the order given, so both sides pass them in the
+// parents-first order a snapshot stores them in.
+template <typename T>
+class MissionStateHasher {
+public:
+    MissionStateHasher(std::vector<Unit<T>*> units, std::vector<SupplyPool*> pools)
+            : m_units(std::move(units)), m_pools(std::move(pools)) {
+        // Resolve the concrete type once, so hashing a tick needs no casts
+        m_kinds.reserve(m_units.size());
+        for (Unit<T>* unit : m_units) {
+            if (dynamic_cast<Marine<T>*>(unit)) m_kinds.push_back(UnitKind::Marine);
+            else if (dynamic_cast<Medic<T>*>(unit)) m_kinds.push_back(UnitKind::Medic);
+            else if (dynamic_cast<Engineer<T>*>(unit)) m_kinds.push_back(UnitKind::Engineer);
+            else throw std::invalid_argument("replay: unknown unit type for " + unit->getName());
+        }
+    }
+
+    std::uint64_t hash() const {
+        std::uint64_t h = 0xCBF29CE484222325ull;
+        for (std::size_t i = 0; i < m_units.size(); ++i) {
+            const Unit<T>* unit = m_units[i];
+            mix(h, unit->getHealth());
+            mix(h, resourcesOf(i));
+            const Position& p = unit->getPosition();
+            mix(h, p.x);
+            mix(h, p.y);
+            mix(h, p.z);
+        }
+        for (const SupplyPool* pool : m_pools) mix(h, pool->available());
+        return h;
+    }
+
+    const std::vector<Unit<T>*>& getUnits() const { return m_units; }
+
+private:
+    T resourcesOf(std::size_t i) const {
+        switch (m_kinds[i]) {
+            case UnitKind::Marine:   return static_cast<Marine<T>*>(m_units[i])->getResourceAmount();
+            case UnitKind::Medic:    return static_cast<Medic<T>*>(m_units[i])->getResourceAmount();
+            case UnitKind::Engineer: return static_cast<Engineer<T>*>(m_units[i])->getResourceAmount();
+        }
+        return T();
+    }
+
+    // Bit pattern of value folded into h, so equal floats hash equally and -0.0 != 0.0
+    template <typename V>
+    static void mix(std::uint64_t& h, V value) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof value);
+        h = (h ^ bits) * 0x100000001B3ull;
+        h ^= h >> 29;
+    }
+
+    std::vector<Unit<T>*> m_units;
+    std::vector<SupplyPool*> m_pools;
+    std::vector<UnitKind> m_kinds;
+};
+
+template <typename T>
+class MissionRecorder {
+public:
+    // Saves the starting state to snapshotFile and opens logFile for commands
+    MissionRecorder(const std::string& logFile, const std::string& snapshotFile, const std::vector<Unit<T>*>& units,
+                    const std::vector<SupplyPool*>& pools)
+            : m_hasher(units, poolsParentsFirst(pools)), m_out(logFile, std::ios::binary | std::ios::trunc) {
+        if (!m_out) throw std::runtime_error("replay: cannot create " + logFile);
+        saveMission<T>(snapshotFile, units, pools);
+        ReplayLogHeader header{};
+        std::memcpy(header.magic, "MREC", 4);
+        header.version = kReplayLogVersion;
+        header.valueSize = sizeof(T);
+        header.valueIsFloat = std::is_floating_point<T>::value;
+        header.unitCount = static_cast<std::uint32_t>(units.size());
+        m_buffer.reserve(kFlushBytes + 64);
+        append(&header, sizeof header);
+    }
+
+    ~MissionRecorder() { flush(); }
+
+    MissionRecorder(const MissionRecorder&) = delete;
+    MissionRecorder& operator=(const MissionRecorder&) = delete;
+
+    // Executes and logs unit->move(distance)
+    void move(std::uint32_t unitIndex, T distance) {
+        writeCommand(ReplayOp::Move, unitIndex);
+        append(&distance, sizeof distance);
+        getUnits()[unitIndex]->move(distance);
+    }
+
+    // Executes and logs unit->action()
+    void action(std::uint32_t unitIndex) {
+        writeCommand(ReplayOp::Action, unitIndex);
+        getUnits()[unitIndex]->action();
+    }
+
+    // Closes the tick with a hash of the state it produced
+    std::uint64_t endTick() {
+        std::uint64_t h = m_hasher.hash();
+        m_buffer.push_back(static_cast<char>(ReplayOp::EndTick));
+        append(&h, sizeof h);
+        ++m_ticks;
+        if (m_buffer.size() >= kFlushBytes) flush();
+        return h;
+    }
+
+    void flush() {
+        m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_out.flush();
+        m_buffer.clear();
+    }
+
+    std::uint64_t tickCount() const { return m_ticks; }
+    const std::vector<Unit<T>*>& getUnits() const { return m_hasher.getUnits(); }
+
+private:
+    static constexpr std::size_t kFlushBytes = 1 << 20;
+
+    void append(const void* data, std::size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+    }
+
+    // Opcode byte, then the zigzag varint delta from the previous unit index
+    void writeCommand(ReplayOp op, std::uint32_t unitIndex) {
+        std::int64_t delta = static_cast<std::int64_t>(unitIndex) - static_cast<std::int64_t>(m_lastUnit);
+        std::uint64_t zigzag = (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63);
+        m_lastUnit = unitIndex;
+        char encoded[11];
+        std::size_t n = 0;
+        encoded[n++] = static_cast<char>(op);
+        do {
+            std::uint8_t byte = zigzag & 0x7F;
+            zigzag >>= 7;
+            encoded[n++] = static_cast<char>(zigzag ? byte | 0x80 : byte);
+        } while (zigzag);
+        append(encoded, n);
+        if (m_buffer.size() >= kFlushBytes) flush();
+    }
+
+    MissionStateHasher<T> m_hasher;
+    std::ofstream m_out;
+    std::vector<char> m_buffer;
+    std::uint32_t m_lastUnit = 0;
+    std::uint64_t m_ticks = 0;
+};
+
+// One recorded performMission tick: every unit moves, then acts
+template <typename T>
+std::uint64_t performMission(MissionRecorder<T>& recorder, T moveDistance) {
+    const auto count = static_cast<std::uint32_t>(recorder.getUnits().size());
+    for (std::uint32_t i = 0; i < count; ++i) {
+        recorder.move(i, moveDistance);
+        recorder.action(i);
+    }
+    return recorder.endTick();
+}
+
+struct ReplayResult {
+    std::uint64_t ticks = 0;
+    std::uint64_t commands = 0;
+    std::int64_t firstMismatchTick = -1;        // -1 when every tick hash matched
+    std::vector<std::uint64_t> recordedHashes;
+    std::vector<std::uint64_t> replayedHashes;
+};
+
+template <typename T>
+class MissionReplayer {
+public:
+    MissionReplayer(const std::string& logFile, const std::string& snapshotFile,
+                    EventSink& events = defaultEventSink())
+            : m_log(logFile), m_mission(restoreMission<T>(snapshotFile, m_arena, events)) {
+        ReplayLogHeader header;
+        if (m_log.size() < sizeof header) throw std::runtime_error("replay: " + logFile + " is too short");
+        std::memcpy(&header, m_log.data(), sizeof header);
+        if (std::memcmp(header.magic, "MREC", 4) != 0 || header.version != kReplayLogVersion)
+            throw std::runtime_error("replay: " + logFile + " is not a version " +
+                                     std::to_string(kReplayLogVersion) + " mission log");
+        if (header.valueSize != sizeof(T) || header.valueIsFloat != std::is_floating_point<T>::value)
+            throw std::runtime_error("replay: log written for another value type");
+        if (header.unitCount != m_mission.units.size())
+            throw std::runtime_error("replay: log and snapshot disagree on the unit count");
+    }
+
+    // Re-issues every command as fast as possible, checking each tick hash
+    ReplayResult run() {
+        ReplayResult result;
+        std::vector<SupplyPool*> pools;
+        for (auto& pool : m_mission.pools) pools.push_back(pool.get());
+        MissionStateHasher<T> hasher(m_mission.units, pools);
+        const char* p = m_log.data() + sizeof(ReplayLogHeader);
+        const char* end = m_log.data() + m_log.size();
+        std::uint32_t unit = 0;
+        auto need = [&](std::size_t n) {
+            if (static_cast<std::size_t>(end - p) < n) throw std::runtime_error("replay: log is truncated");
+        };
+        while (p < end) {
+            auto op = static_cast<ReplayOp>(*p++);
+            if (op == ReplayOp::EndTick) {
+                std::uint64_t recorded;
+                need(sizeof recorded);
+                std::memcpy(&recorded, p, sizeof recorded);
+                p += sizeof recorded;
+                std::uint64_t replayed = hasher.hash();
+                if (replayed != recorded && result.firstMismatchTick < 0)
+                    result.firstMismatchTick = static_cast<std::int64_t>(result.ticks);
+                result.recordedHashes.push_back(recorded);
+                result.replayedHashes.push_back(replayed);
+                ++result.ticks;
+                continue;
+            }
+            std::uint64_t zigzag = 0;
+            for (int shift = 0;; shift += 7) {
+                need(1);
+                std::uint8_t byte = static_cast<std::uint8_t>(*p++);
+                zigzag |= std::uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) break;
+                if (shift > 56) throw std::runtime_error("replay: bad unit index");
+            }
+            auto delta = static_cast<std::int64_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+            unit = static_cast<std::uint32_t>(static_cast<std::int64_t>(unit) + delta);
+            if (unit >= m_mission.units.size()) throw std::runtime_error("replay: unit index out of range");
+            if (op == ReplayOp::Move) {
+                T distance;
+                need(sizeof distance);
+                std::memcpy(&distance, p, sizeof distance);
+                p += sizeof distance;
+                m_mission.units[unit]->move(distance);
+            } else if (op == ReplayOp::Action) {
+                m_mission.units[unit]->action();
+            } else {
+                throw std::runtime_error("replay: unknown command");
+            }
+            ++result.commands;
+        }
+        return result;
+    }
+
+    const std::vector<Unit<T>*>& getUnits() const { return m_mission.units; }
+
+private:
+    SnapshotMapping m_log;
+    MissionArena m_arena{1 << 20};
+    RestoredMission<T> m_mission;
+};
+
+/*
+int main() {
+    NullEventSink quiet;
+    SupplyPool base("Base Camp", "ammo", 5000, quiet);
+    MissionArena arena;
+    std::vector<Unit<int>*> units{arena.create<Marine<int>>("John Doe", 100, 3, quiet),
+                                  arena.create<Medic<int>>("Jane Smith", 80, 5, quiet)};
+    static_cast<Marine<int>*>(units[0])->supplyFrom(&base, 30);
+    {
+        MissionRecorder<int> recorder("mission.log", "mission.snap", units, {&base});
+        for (int tick = 0; tick < 10; ++tick) performMission(recorder, 50);
+    }
+
+    MissionReplayer<int> replayer("mission.log", "mission.snap", quiet);
+    ReplayResult result = replayer.run();
+    std::cout << result.ticks << " ticks, first mismatch: " << result.firstMismatchTick << std::endl;
+}
+*/
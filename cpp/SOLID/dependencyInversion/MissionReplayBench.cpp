@@ -0,0 +1,126 @@
+/**
+ * @file MissionReplayBench.cpp
+ * @brief Recording overhead, log size and replay speed of MissionRecorder/MissionReplayer.
+ *
+ * Usage: MissionReplayBench [units] [ticks] [directory]
+ * Runs the same mission plain and recorded, replays the log, then replays it
+ * against a snapshot with one unit altered to show the mismatch is caught.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BenchUtil.cpp"
+#include "MissionReplay.cpp"
+
+// Builds the same squad into arena each time it is called
+std::vector<Unit<int>*> buildSquad(MissionArena& arena, std::size_t count, SupplyPool& pool, EventSink& events) {
+    std::vector<Unit<int>*> units;
+    units.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string name = "Unit " + std::to_string(i);
+        switch (i % 3) {
+            case 0: {
+                auto* marine = arena.create<Marine<int>>(name, 100, 3, events);
+                marine->supplyFrom(&pool, 5);
+                units.push_back(marine);
+                break;
+            }
+            case 1: units.push_back(arena.create<Medic<int>>(name, 80, 5, events)); break;
+            default: units.push_back(arena.create<Engineer<int>>(name, 90, 10, events));
+        }
+        units.back()->setHeading({static_cast<float>(i % 7) - 3.0f, static_cast<float>(i % 5) - 2.0f, 0.0f});
+    }
+    return units;
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t unitCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const int ticks = argc > 2 ? std::atoi(argv[2]) : 20;
+    const std::string dir = argc > 3 ? argv[3] : "/tmp";
+    const std::string logFile = dir + "/mission.replay", snapFile = dir + "/mission.replay.snap";
+    const double commands = 2.0 * static_cast<double>(unitCount) * ticks;
+    NullEventSink quiet;
+
+    {
+        SupplyPool pool("Base Camp", "ammo", 200000, quiet);
+        MissionArena arena(1 << 20);
+        auto units = buildSquad(arena, unitCount, pool, quiet);
+        double ns = timeNs([&] {
+            for (int t = 0; t < ticks; ++t) performMission(units, 1);
+        });
+        std::cout << "plain    : " << ns / commands << " ns/command" << std::endl;
+    }
+
+    std::uint64_t lastHash = 0;
+    {
+        SupplyPool pool("Base Camp", "ammo", 200000, quiet);
+        MissionArena arena(1 << 20);
+        auto units = buildSquad(arena, unitCount, pool, quiet);
+        std::vector<SupplyPool*> pools{&pool};
+        MissionRecorder<int> recorder(logFile, snapFile, units, pools);
+        double hashNs = 0;
+        double ns = timeNs([&] {
+            for (int t = 0; t < ticks; ++t) lastHash = performMission(recorder, 1);
+            recorder.flush();
+        });
+        MissionStateHasher<int> hasher(units, pools);
+        hashNs = timeNs([&] { hasher.hash(); }) * ticks;
+        std::ifstream log(logFile, std::ios::binary | std::ios::ate);
+        std::cout << "recorded : " << ns / commands << " ns/command (" << hashNs / commands
+                  << " of it tick hashing), " << static_cast<double>(log.tellg()) / commands << " bytes/command"
+                  << std::endl;
+    }
+
+    MissionReplayer<int> replayer(logFile, snapFile, quiet);
+    ReplayResult result;
+    double replayNs = timeNs([&] { result = replayer.run(); });
+    std::cout << "replay   : " << replayNs / commands << " ns/command, " << result.ticks << " ticks, "
+              << result.commands << " commands, "
+              << (result.firstMismatchTick < 0 && result.replayedHashes.back() == lastHash ? "all hashes match"
+                                                                                            : "MISMATCH")
+              << std::endl;
+    bool ok = result.firstMismatchTick < 0;
+
+    // Same log against a snapshot where one unit starts elsewhere
+    if (unitCount > 0) {
+        SupplyPool pool("Base Camp", "ammo", 200000, quiet);
+        MissionArena arena(1 << 20);
+        auto units = buildSquad(arena, unitCount, pool, quiet);
+        units[unitCount / 2]->setPosition({0.0f, 0.0f, 1.0f});
+        saveMission<int>(snapFile, units, {&pool});
+        MissionReplayer<int> diverged(logFile, snapFile, quiet);
+        ReplayResult bad = diverged.run();
+        std::cout << "altered  : first mismatch at tick " << bad.firstMismatchTick << std::endl;
+        ok = ok && bad.firstMismatchTick == 0;
+    }
+    // Squads drawing from a base, with the pools listed children first
+    {
+        SupplyPool base("Base Camp", "ammo", 200000, quiet);
+        SupplyPool alpha("Alpha Squad", "ammo", 0, quiet, &base, 50);
+        SupplyPool bravo("Bravo Squad", "ammo", 0, quiet, &base, 50);
+        MissionArena arena(1 << 20);
+        const std::size_t squadSize = std::min<std::size_t>(unitCount, 3000);
+        auto units = buildSquad(arena, squadSize, base, quiet);
+        for (std::size_t i = 0; i < squadSize; i += 3)
+            static_cast<Marine<int>*>(units[i])->supplyFrom(i % 2 ? &alpha : &bravo, 5);
+        {
+            MissionRecorder<int> recorder(logFile, snapFile, units, {&alpha, &bravo, &base});
+            for (int t = 0; t < ticks; ++t) performMission(recorder, 1);
+        }
+        MissionReplayer<int> squads(logFile, snapFile, quiet);
+        ReplayResult pooled = squads.run();
+        std::cout << "3 pools  : " << pooled.ticks << " ticks, "
+                  << (pooled.firstMismatchTick < 0 ? "all hashes match" : "MISMATCH") << std::endl;
+        ok = ok && pooled.firstMismatchTick < 0;
+    }
+
+    std::remove(logFile.c_str());
+    std::remove(snapFile.c_str());
+    return ok ? 0 : 1;
+}
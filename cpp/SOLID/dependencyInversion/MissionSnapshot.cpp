@@ -0,0 +1,316 @@
+#pragma once
+/**
+ * @file MissionSnapshot.cpp
+ * @brief Versioned binary checkpoints of units and supply pools, restored through mmap.
+ *
+ * Phase 11: Checkpoint and restore
+ * A mission's state lives in Unit<T> objects scattered over the heap. This
+ * phase writes it to one file: a header, a table of fixed-size unit records,
+ * a table of pool records, and one blob holding every name. Records refer to
+ * names and pools by offset and index, never by pointer, so the file can be
+ * mapped and read in place.
+ *
+ * Restore maps the file, checks the header, and walks the unit table once,
+ * constructing each unit in a MissionArena straight from its record. Nothing
+ * is parsed; names are copied directly out of the mapped blob. Pools are restored
+ * first (parents before children), so units can be relinked to them.
+ *
+ * The file uses the writer's byte order and value type; both are recorded in
+ * the header, and a mismatch is rejected instead of misread.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MissionArena.cpp"
+#include "ResourceMgmtUnitTemplate.cpp"
+#include "ResourcePool.cpp"
+#include "UnitStore.cpp"
+
+constexpr std::uint32_t kSnapshotVersion = 1;
+constexpr std::uint32_t kNoPool = 0xFFFFFFFF;
+
+struct SnapshotHeader {
+    char magic[4];              // "MSNP"
+    std::uint32_t version;
+    std::uint32_t byteOrder;    // 0x01020304 as written by the saving machine
+    std::uint16_t valueSize;    // sizeof(T)
+    std::uint16_t valueIsFloat;
+    std::uint64_t unitCount;
+    std::uint64_t poolCount;
+    std::uint64_t unitsOffset;
+    std::uint64_t poolsOffset;
+    std::uint64_t namesOffset;
+    std::uint64_t namesSize;
+};
+
+// Names are (offset, length) into the name blob
+struct NameRef {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+template <typename T>
+struct UnitRecord {
+    Position position;
+    Position heading;
+    T health;
+    T resources;
+    T refillAmount;
+    NameRef name;
+    std::uint32_t pool;         // index into the pool table, or kNoPool
+    UnitKind kind;
+};
+
+struct PoolRecord {
+    NameRef name;
+    NameRef resourceName;
+    std::int64_t stock;
+    std::int64_t refillBatch;
+    std::uint32_t parent;       // index of an earlier pool, or kNoPool
+};
+
+static_assert(std::is_trivially_copyable<UnitRecord<int>>::value, "unit records are copied as bytes");
+static_assert(std::is_trivially_copyable<PoolRecord>::value, "pool records are copied as bytes");
+
+// Units and pools rebuilt from a snapshot. The units live in the arena
+// passed to restoreMission and are valid until it is released.
+template <typename T>
+struct RestoredMission {
+    std::vector<Unit<T>*> units;
+    std::vector<std::unique_ptr<SupplyPool>> pools;
+};
+
+// The order saveMission stores pools in: parents first, so restore can link
+// each pool to one already built; otherwise in the order given
+inline std::vector<SupplyPool*> poolsParentsFirst(const std::vector<SupplyPool*>& pools) {
+    std::vector<SupplyPool*> ordered;
+    std::unordered_set<const SupplyPool*> placed;
+    std::function<void(SupplyPool*)> place = [&](SupplyPool* pool) {
+        if (placed.count(pool)) return;
+        if (SupplyPool* parent = pool->getParent()) {
+            if (std::find(pools.begin(), pools.end(), parent) == pools.end())
+                throw std::invalid_argument("snapshot: parent of a pool is not in the pool list");
+            place(parent);
+        }
+        placed.insert(pool);
+        ordered.push_back(pool);
+    };
+    for (SupplyPool* pool : pools) place(pool);
+    return ordered;
+}
+
+// Writes units and the pools they draw from. Pools are given in any order,
+// but a pool's parent must be in the list too.
+template <typename T>
+void saveMission(const std::string& filename, const std::vector<Unit<T>*>& units,
+                 const std::vector<SupplyPool*>& pools) {
+    std::string names;
+    // NameRef holds 32-bit offsets, so the whole blob must stay below 4 GiB
+    auto addName = [&names](const std::string& name) {
+        if (name.size() > std::numeric_limits<std::uint32_t>::max() - names.size())
+            throw std::length_error("snapshot: names do not fit in 4 GiB");
+        NameRef ref{static_cast<std::uint32_t>(names.size()), static_cast<std::uint32_t>(name.size())};
+        names += name;
+        return ref;
+    };
+
+    std::unordered_map<const SupplyPool*, std::uint32_t> poolIndex;
+    std::vector<PoolRecord> poolRecords;
+    for (SupplyPool* pool : poolsParentsFirst(pools)) {
+        std::uint32_t parent = pool->getParent() ? poolIndex.at(pool->getParent()) : kNoPool;
+        poolIndex[pool] = static_cast<std::uint32_t>(poolRecords.size());
+        PoolRecord& r = poolRecords.emplace_back();
+        std::memset(static_cast<void*>(&r), 0, sizeof r);  // padding too, as for unit records
+        r.name = addName(pool->getName());
+        r.resourceName = addName(pool->getResourceName());
+        r.stock = pool->available();
+        r.refillBatch = pool->getRefillBatch();
+        r.parent = parent;
+    }
+
+    std::vector<UnitRecord<T>> unitRecords(units.size());
+    for (std::size_t i = 0; i < units.size(); ++i) {
+        Unit<T>* unit = units[i];
+        UnitRecord<T>& r = unitRecords[i];
+        std::memset(static_cast<void*>(&r), 0, sizeof r);  // zero padding too, so files are reproducible
+        r.position = unit->getPosition();
+        r.heading = unit->getHeading();
+        r.health = unit->getHealth();
+        r.name = addName(unit->getName());
+
+        // Snapshots are rare, so finding the concrete type by cast is acceptable here
+        auto fill = [&](auto* typed, UnitKind kind) {
+            r.kind = kind;
+            r.resources = typed->getResourceAmount();
+            r.refillAmount = typed->getRefillAmount();
+            SupplyPool* pool = typed->getSupplyPool();
+            if (pool && !poolIndex.count(pool))
+                throw std::invalid_argument("snapshot: a unit draws from a pool that is not in the pool list");
+            r.pool = pool ? poolIndex.at(pool) : kNoPool;
+        };
+        if (auto* marine = dynamic_cast<Marine<T>*>(unit)) fill(marine, UnitKind::Marine);
+        else if (auto* medic = dynamic_cast<Medic<T>*>(unit)) fill(medic, UnitKind::Medic);
+        else if (auto* engineer = dynamic_cast<Engineer<T>*>(unit)) fill(engineer, UnitKind::Engineer);
+        else throw std::invalid_argument("snapshot: unknown unit type for " + unit->getName());
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, "MSNP", 4);
+    header.version = kSnapshotVersion;
+    header.byteOrder = 0x01020304;
+    header.valueSize = sizeof(T);
+    header.valueIsFloat = std::is_floating_point<T>::value;
+    header.unitCount = unitRecords.size();
+    header.poolCount = poolRecords.size();
+    header.unitsOffset = sizeof header;
+    header.poolsOffset = header.unitsOffset + unitRecords.size() * sizeof(UnitRecord<T>);
+    header.namesOffset = header.poolsOffset + poolRecords.size() * sizeof(PoolRecord);
+    header.namesSize = names.size();
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof header);
+    out.write(reinterpret_cast<const char*>(unitRecords.data()),
+              static_cast<std::streamsize>(unitRecords.size() * sizeof(UnitRecord<T>)));
+    out.write(reinterpret_cast<const char*>(poolRecords.data()),
+              static_cast<std::streamsize>(poolRecords.size() * sizeof(PoolRecord)));
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+    out.close();
+    if (!out) throw std::runtime_error("snapshot: cannot write " + filename);
+}
+
+// Read-only mapping of a whole file, unmapped on destruction
+class SnapshotMapping {
+public:
+    explicit SnapshotMapping(const std::string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("snapshot: cannot open " + filename);
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("snapshot: " + filename + " is empty");
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("snapshot: cannot map " + filename);
+        m_data = static_cast<const char*>(p);
+        ::madvise(p, m_size, MADV_SEQUENTIAL);
+    }
+
+    ~SnapshotMapping() { ::munmap(const_cast<char*>(m_data), m_size); }
+
+    SnapshotMapping(const SnapshotMapping&) = delete;
+    SnapshotMapping& operator=(const SnapshotMapping&) = delete;
+
+    const char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+// Rebuilds the units of a snapshot in arena and returns them with their pools
+template <typename T>
+RestoredMission<T> restoreMission(const std::string& filename, MissionArena& arena,
+                                  EventSink& events = defaultEventSink()) {
+    SnapshotMapping file(filename);
+    SnapshotHeader header;
+    if (file.size() < sizeof header) throw std::runtime_error("snapshot: " + filename + " is too short");
+    std::memcpy(&header, file.data(), sizeof header);
+    if (std::memcmp(header.magic, "MSNP", 4) != 0) throw std::runtime_error("snapshot: bad magic in " + filename);
+    if (header.version != kSnapshotVersion)
+        throw std::runtime_error("snapshot: unsupported version " + std::to_string(header.version));
+    if (header.byteOrder != 0x01020304) throw std::runtime_error("snapshot: written with another byte order");
+    if (header.valueSize != sizeof(T) || header.valueIsFloat != std::is_floating_point<T>::value)
+        throw std::runtime_error("snapshot: written for another value type");
+    // Sections are checked against the room they have, by division, so no count can wrap
+    if (header.unitsOffset > header.poolsOffset || header.poolsOffset > header.namesOffset ||
+        header.namesOffset > file.size() ||
+        header.unitCount > (header.poolsOffset - header.unitsOffset) / sizeof(UnitRecord<T>) ||
+        header.poolCount > (header.namesOffset - header.poolsOffset) / sizeof(PoolRecord) ||
+        header.namesSize > file.size() - header.namesOffset)
+        throw std::runtime_error("snapshot: " + filename + " is truncated");
+
+    const char* names = file.data() + header.namesOffset;
+    auto nameOf = [&](NameRef ref) {
+        if (std::uint64_t(ref.offset) + ref.length > header.namesSize)
+            throw std::runtime_error("snapshot: name out of range");
+        return std::string(names + ref.offset, ref.length);
+    };
+
+    RestoredMission<T> mission;
+    mission.pools.reserve(header.poolCount);
+    for (std::uint64_t i = 0; i < header.poolCount; ++i) {
+        PoolRecord r;
+        std::memcpy(&r, file.data() + header.poolsOffset + i * sizeof r, sizeof r);
+        if (r.parent != kNoPool && r.parent >= i) throw std::runtime_error("snapshot: pool parent out of order");
+        SupplyPool* parent = r.parent == kNoPool ? nullptr : mission.pools[r.parent].get();
+        mission.pools.push_back(std::make_unique<SupplyPool>(nameOf(r.name), nameOf(r.resourceName), r.stock,
+                                                             events, parent, r.refillBatch));
+    }
+
+    // Records are copied out rather than referenced: the file gives no alignment guarantee
+    mission.units.reserve(header.unitCount);
+    const char* records = file.data() + header.unitsOffset;
+    for (std::uint64_t i = 0; i < header.unitCount; ++i) {
+        UnitRecord<T> r;
+        std::memcpy(&r, records + i * sizeof r, sizeof r);
+        std::string name = nameOf(r.name);
+        SupplyPool* pool = nullptr;
+        if (r.pool != kNoPool) {
+            if (r.pool >= mission.pools.size()) throw std::runtime_error("snapshot: unit pool out of range");
+            pool = mission.pools[r.pool].get();
+        }
+        auto place = [&](auto* unit) {
+            unit->setPosition(r.position);
+            unit->setHeading(r.heading);
+            if (pool) unit->supplyFrom(pool, r.refillAmount);
+            mission.units.push_back(unit);
+        };
+        switch (r.kind) {
+            case UnitKind::Marine:   place(arena.create<Marine<T>>(name, r.health, r.resources, events)); break;
+            case UnitKind::Medic:    place(arena.create<Medic<T>>(name, r.health, r.resources, events)); break;
+            case UnitKind::Engineer: place(arena.create<Engineer<T>>(name, r.health, r.resources, events)); break;
+            default: throw std::runtime_error("snapshot: unknown unit kind");
+        }
+    }
+    return mission;
+}
+
+/*
+int main() {
+    MissionArena arena;
+    SupplyPool base("Base Camp", "ammo", 5000);
+    std::vector<Unit<int>*> units;
+    auto* marine = arena.create<Marine<int>>("John Doe", 100, 30);
+    marine->supplyFrom(&base, 30);
+    units.push_back(marine);
+    units.push_back(arena.create<Medic<int>>("Jane Smith", 80, 5));
+    performMission(units, 50);
+
+    saveMission<int>("mission.snap", units, {&base});
+
+    MissionArena restoredArena;
+    RestoredMission<int> restored = restoreMission<int>("mission.snap", restoredArena);
+    performMission(restored.units, 50);
+}
+*/
@@ -0,0 +1,110 @@
+/**
+ * @file MissionSnapshotBench.cpp
+ * @brief Save and restore time of a large mission snapshot.
+ *
+ * Usage: MissionSnapshotBench [units] [file]
+ * Builds a squad of Marines, Medics and Engineers drawing from squad and base
+ * pools, saves it, restores it into a fresh arena and compares every unit,
+ * then checks that a unit count chosen to wrap the section bounds is refused.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "BenchUtil.cpp"
+#include "MissionSnapshot.cpp"
+
+template <typename T>
+bool sameUnit(Unit<T>* a, Unit<T>* b) {
+    auto resources = [](Unit<T>* u) -> T {
+        if (auto* m = dynamic_cast<Marine<T>*>(u)) return m->getResourceAmount();
+        if (auto* m = dynamic_cast<Medic<T>*>(u)) return m->getResourceAmount();
+        return dynamic_cast<Engineer<T>*>(u)->getResourceAmount();
+    };
+    return a->getName() == b->getName() && a->getHealth() == b->getHealth() && resources(a) == resources(b) &&
+           a->getPosition().x == b->getPosition().x && a->getPosition().y == b->getPosition().y &&
+           typeid(*a) == typeid(*b);
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t unitCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::string file = argc > 2 ? argv[2] : "/tmp/mission.snap";
+
+    NullEventSink quiet;
+    SupplyPool base("Base Camp", "ammo", 1000000, quiet);
+    SupplyPool alpha("Alpha Squad", "ammo", 500, quiet, &base, 1000);
+    SupplyPool bravo("Bravo Squad", "ammo", 500, quiet, &base, 1000);
+
+    MissionArena arena(1 << 20);
+    std::vector<Unit<int>*> units;
+    units.reserve(unitCount);
+    for (std::size_t i = 0; i < unitCount; ++i) {
+        std::string name = "Unit " + std::to_string(i);
+        Unit<int>* unit = nullptr;
+        switch (i % 3) {
+            case 0: {
+                auto* marine = arena.create<Marine<int>>(name, 100, 30, quiet);
+                marine->supplyFrom(i % 2 ? &alpha : &bravo, 30);
+                unit = marine;
+                break;
+            }
+            case 1: unit = arena.create<Medic<int>>(name, 80, 5, quiet); break;
+            default: unit = arena.create<Engineer<int>>(name, 90, 10, quiet);
+        }
+        unit->setPosition({static_cast<float>(i % 1000), static_cast<float>(i / 1000), 0.0f});
+        units.push_back(unit);
+    }
+    for (int tick = 0; tick < 3; ++tick) performMission(units, 1);
+
+    double saveNs = timeNs([&] { saveMission<int>(file, units, {&alpha, &bravo, &base}); });
+    reportNs("save", saveNs, unitCount);
+
+    MissionArena restoredArena(1 << 20);
+    RestoredMission<int> restored;
+    double restoreNs = timeNs([&] { restored = restoreMission<int>(file, restoredArena, quiet); });
+    reportNs("restore", restoreNs, unitCount);
+
+    bool same = restored.units.size() == units.size() && restored.pools.size() == 3;
+    for (std::size_t i = 0; same && i < units.size(); ++i) same = sameUnit(units[i], restored.units[i]);
+    std::int64_t stock = 0;
+    for (auto& pool : restored.pools) stock += pool->available();
+    same = same && stock == base.available() + alpha.available() + bravo.available();
+    // the same mission saves to the same bytes, padding included
+    const std::string again = file + ".again";
+    saveMission<int>(again, units, {&alpha, &bravo, &base});
+    auto bytesOf = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+    bool reproducible = bytesOf(file) == bytesOf(again);
+    std::remove(again.c_str());
+
+    std::cout << "restored " << restored.units.size() << " units and " << restored.pools.size() << " pools: "
+              << (same ? "identical" : "MISMATCH") << ", saved again " << (reproducible ? "byte for byte" : "DIFFERENTLY")
+              << std::endl;
+
+    // unitCount * sizeof(record) wraps to one record: must be refused, not read
+    {
+        std::fstream snapshot(file, std::ios::binary | std::ios::in | std::ios::out);
+        SnapshotHeader header;
+        snapshot.read(reinterpret_cast<char*>(&header), sizeof header);
+        header.unitCount = ~std::uint64_t(0) / sizeof(UnitRecord<int>) + 2;
+        snapshot.seekp(0);
+        snapshot.write(reinterpret_cast<const char*>(&header), sizeof header);
+    }
+    bool refused = false;
+    try {
+        MissionArena scratch(1 << 16);
+        restoreMission<int>(file, scratch, quiet);
+    } catch (const std::runtime_error&) {
+        refused = true;
+    }
+    std::cout << "wrapping unit count: " << (refused ? "refused" : "ACCEPTED") << std::endl;
+    std::remove(file.c_str());
+    return same && reproducible && refused ? 0 : 1;
+}
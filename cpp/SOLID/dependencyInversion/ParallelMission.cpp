@@ -0,0 +1,228 @@
+#pragma once
+/**
+ * @file ParallelMission.cpp
+ * @brief Work-stealing thread pool and parallel performMission overloads.
+ *
+ * Phase 7: Parallel missions
+ * A mission tick splits the units into fixed-size chunks. Chunks are dealt
+ * round-robin into per-thread queues; a thread works from the back of its own
+ * queue and steals from the front of the others once it runs dry.
+ *
+ * Each unit belongs to exactly one chunk, so its ResourceManager state is only
+ * ever touched by one thread per tick. Per-chunk results land in a slot
+ * indexed by chunk number and are summed in chunk order, so the aggregate does
+ * not depend on which thread ran what.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "ResourceMgmtUnitTemplate.cpp"
+#include "UnitStore.cpp"
+
+class WorkStealingPool {
+public:
+    // threads counts the calling thread, which also runs chunks
+    explicit WorkStealingPool(std::size_t threads = std::thread::hardware_concurrency())
+            : m_queues(std::max<std::size_t>(threads, 1)) {
+        for (std::size_t i = 1; i < m_queues.size(); ++i)
+            m_workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    std::size_t threadCount() const { return m_queues.size(); }
+
+    // Runs fn(chunk) for every chunk in [0, chunks) and waits for all of them.
+    // The first exception thrown by fn is rethrown here.
+    template <typename Fn>
+    void parallelFor(std::size_t chunks, Fn&& fn) {
+        if (chunks == 0) return;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = [&fn](std::size_t chunk) { fn(chunk); };
+            m_error = nullptr;
+            m_remaining.store(chunks);
+            for (std::size_t c = 0; c < chunks; ++c) {
+                Queue& q = m_queues[c % m_queues.size()];
+                std::lock_guard<std::mutex> qlock(q.mutex);
+                q.chunks.push_back(c);
+            }
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        drain(0);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_active == 0 && m_remaining.load() == 0; });
+        m_job = nullptr;
+        if (m_error) std::rethrow_exception(m_error);
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> chunks;
+    };
+
+    std::optional<std::size_t> take(std::size_t self) {
+        {
+            Queue& own = m_queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.chunks.empty()) {
+                std::size_t c = own.chunks.back();
+                own.chunks.pop_back();
+                return c;
+            }
+        }
+        for (std::size_t i = 1; i < m_queues.size(); ++i) {
+            Queue& victim = m_queues[(self + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.chunks.empty()) {
+                std::size_t c = victim.chunks.front();
+                victim.chunks.pop_front();
+                return c;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void drain(std::size_t self) {
+        while (auto chunk = take(self)) {
+            try {
+                m_job(*chunk);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error) m_error = std::current_exception();
+            }
+            if (m_remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_done.notify_all();
+            }
+        }
+    }
+
+    void workerLoop(std::size_t self) {
+        std::size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+                if (m_stop) return;
+                seen = m_generation;
+                ++m_active;
+            }
+            drain(self);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_active;
+            }
+            m_done.notify_all();
+        }
+    }
+
+    std::vector<Queue> m_queues;
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::function<void(std::size_t)> m_job;
+    std::exception_ptr m_error;
+    std::atomic<std::size_t> m_remaining{0};
+    std::size_t m_generation = 0;
+    std::size_t m_active = 0;
+    bool m_stop = false;
+};
+
+constexpr std::size_t kMissionChunkSize = 4096;
+
+// Parallel performMission over Unit<T>*. No unit is touched by two threads,
+// but units share their EventSink and PositionTracker: give them a
+// thread-safe sink, and wrap the call in SpatialGrid::beginBatch()/endBatch()
+// when they are tracked.
+template <typename T>
+void performMission(WorkStealingPool& pool, std::vector<Unit<T>*>& units, T moveDistance,
+                    std::size_t chunkSize = kMissionChunkSize) {
+    const std::size_t chunks = (units.size() + chunkSize - 1) / chunkSize;
+    pool.parallelFor(chunks, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * chunkSize;
+        const std::size_t end = std::min(begin + chunkSize, units.size());
+        for (std::size_t i = begin; i < end; ++i) {
+            units[i]->move(moveDistance);
+            units[i]->action();
+        }
+    });
+}
+
+// Parallel performMission over a UnitStore; the report matches the serial one
+template <typename T>
+MissionReport performMission(WorkStealingPool& pool, UnitStore<T>& store, T moveDistance,
+                             std::size_t chunkSize = kMissionChunkSize) {
+    struct Range {
+        UnitColumns<T>* cols;
+        std::size_t begin;
+        std::size_t end;
+    };
+    std::vector<Range> ranges;
+    for (std::size_t k = 0; k < kUnitKindCount; ++k) {
+        auto& cols = store.columns(static_cast<UnitKind>(k));
+        for (std::size_t begin = 0; begin < cols.size(); begin += chunkSize)
+            ranges.push_back({&cols, begin, std::min(begin + chunkSize, cols.size())});
+    }
+
+    std::vector<MissionReport> partial(ranges.size());
+    pool.parallelFor(ranges.size(), [&](std::size_t chunk) {
+        const Range& r = ranges[chunk];
+        T* position = r.cols->position.data();
+        T* resources = r.cols->resources.data();
+        std::size_t used = 0;
+        for (std::size_t i = r.begin; i < r.end; ++i) {
+            position[i] += moveDistance;
+            const bool has = resources[i] > T{};
+            resources[i] -= static_cast<T>(has);
+            used += has;
+        }
+        partial[chunk] = {r.end - r.begin, used, (r.end - r.begin) - used};
+    });
+
+    MissionReport report;
+    for (const auto& p : partial) {
+        report.unitsMoved += p.unitsMoved;
+        report.resourcesUsed += p.resourcesUsed;
+        report.outOfResource += p.outOfResource;
+    }
+    return report;
+}
+
+/*
+ * int main() {
+    WorkStealingPool pool;
+    UnitStore<int> store;
+    for (int i = 0; i < 100000; ++i) store.addMarine("Marine " + std::to_string(i), 100, 30);
+
+    MissionReport report = performMission(pool, store, 50);
+    std::cout << report.resourcesUsed << " rounds fired" << std::endl;
+    return 0;
+}
+ */
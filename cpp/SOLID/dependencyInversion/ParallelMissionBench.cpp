@@ -0,0 +1,63 @@
+/**
+ * @file ParallelMissionBench.cpp
+ * @brief Scaling of the parallel performMission at 1/2/4/8/N threads.
+ *
+ * Usage: ParallelMissionBench [units] [ticks]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchUtil.cpp"
+#include "ParallelMission.cpp"
+
+static UnitStore<int> makeStore(std::size_t unitCount) {
+    UnitStore<int> store;
+    for (std::size_t i = 0; i < unitCount; ++i) {
+        std::string name = "Unit " + std::to_string(i);
+        switch (i % 3) {
+            case 0:  store.addMarine(name, 100, 30); break;
+            case 1:  store.addMedic(name, 80, 5); break;
+            default: store.addEngineer(name, 90, 10); break;
+        }
+    }
+    return store;
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t unitCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const int ticks = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::vector<std::size_t> threadCounts{1, 2, 4, 8};
+    const std::size_t hw = std::thread::hardware_concurrency();
+    if (hw > 8) threadCounts.push_back(hw);
+
+    UnitStore<int> reference = makeStore(unitCount);
+    MissionReport expected;
+    for (int t = 0; t < ticks; ++t) expected = performMission(reference, 50);
+
+    std::cout << unitCount << " units, " << ticks << " ticks, "
+              << hw << " hardware threads" << std::endl;
+
+    double baseNs = 0;
+    for (std::size_t threads : threadCounts) {
+        UnitStore<int> store = makeStore(unitCount);
+        WorkStealingPool pool(threads);
+        MissionReport report;
+        double ns = timeNs([&] {
+            for (int t = 0; t < ticks; ++t) report = performMission(pool, store, 50);
+        });
+        if (threads == 1) baseNs = ns;
+
+        const bool same = report.unitsMoved == expected.unitsMoved
+                && report.resourcesUsed == expected.resourcesUsed
+                && report.outOfResource == expected.outOfResource;
+        std::cout << threads << " threads: " << ns / 1e6 << " ms, "
+                  << ns / static_cast<double>(unitCount * ticks) << " ns/unit, speedup "
+                  << baseNs / ns << (same ? "" : " (REPORT MISMATCH)") << std::endl;
+    }
+    return 0;
+}
@@ -1,3 +1,4 @@
+#pragma once
 /**
  * @file ResourecMgmtUnitTemplate.cpp
  * @author chitownj
@@ -8,57 +9,199 @@
  */
 // TODO: Implement this class
 
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "MissionEvents.cpp"
+#include "ResourcePool.cpp"
+#include "SpatialIndex.cpp"
+
 // Resource management mixin
 template <typename T, typename DerivedClass>
 class ResourceManager {
 public:
     ResourceManager(const std::string& resourceName, T initialAmount)
-            : m_resourceName(resourceName), m_resourceAmount(initialAmount) {}
+            : m_resourceName(resourceName), m_resourceAmount(initialAmount),
+              m_resourceId(ResourceNames::idOf(resourceName)) {}
+
+    // Refill up to refillAmount from pool whenever this unit runs out; nullptr stops it
+    void supplyFrom(SupplyPool* pool, T refillAmount) {
+        m_pool = pool;
+        m_refillAmount = refillAmount;
+    }
+
+    T getResourceAmount() const { return m_resourceAmount; }
+    SupplyPool* getSupplyPool() const { return m_pool; }
+    T getRefillAmount() const { return m_refillAmount; }
 
     void useResource() {
+        auto* self = static_cast<DerivedClass*>(this);
+        if (m_resourceAmount <= 0 && m_pool) {
+            std::int64_t received = m_pool->drawUpTo(static_cast<std::int64_t>(m_refillAmount));
+            if (received > 0) {
+                m_resourceAmount += static_cast<T>(received);
+                self->getEvents().record({self->getId(), m_resourceId, EventKind::Resupplied,
+                                          static_cast<double>(received)});
+            }
+        }
         if (m_resourceAmount > 0) {
             m_resourceAmount--;
-            std::cout << static_cast<DerivedClass*>(this)->getName()
-                      << " used a " << m_resourceName << ". "
-                      << m_resourceName << " left: " << m_resourceAmount << std::endl;
+            self->getEvents().record({self->getId(), m_resourceId, EventKind::UsedResource,
+                                      static_cast<double>(m_resourceAmount)});
         } else {
-            std::cout << static_cast<DerivedClass*>(this)->getName()
-                      << " is out of " << m_resourceName << "!" << std::endl;
+            self->getEvents().record({self->getId(), m_resourceId, EventKind::OutOfResource, 0});
         }
     }
 
 protected:
     std::string m_resourceName;
     T m_resourceAmount;
+    std::uint16_t m_resourceId;
+    SupplyPool* m_pool = nullptr;
+    T m_refillAmount = T();
 };
 
 template <typename T>
 class Unit {
 public:
-    Unit(const std::string& name, T health) : m_name(name), m_health(health) {}
+    Unit(std::string name, T health, EventSink& events = defaultEventSink())
+            : m_name(std::move(name)), m_health(health), m_events(&events), m_id(nextUnitId()) {
+        m_events->nameUnit(m_id, m_name);
+    }
     virtual void move(T distance) = 0;
     virtual void action() = 0;
-    virtual ~Unit() = default;
+    virtual ~Unit() { retire(); }
+
+    // A copy is a new unit with its own id; a move takes over the id
+    Unit(const Unit& other)
+            : m_name(other.m_name), m_health(other.m_health), m_events(other.m_events), m_id(nextUnitId()),
+              m_position(other.m_position), m_heading(other.m_heading), m_tracker(other.m_tracker) {
+        m_events->nameUnit(m_id, m_name);
+        if (m_tracker)
+            m_tracker->moved(m_id, m_position);
+    }
+
+    Unit(Unit&& other) noexcept
+            : m_name(std::move(other.m_name)), m_health(other.m_health), m_events(other.m_events),
+              m_id(std::exchange(other.m_id, kNoUnitId)), m_position(other.m_position),
+              m_heading(other.m_heading), m_tracker(std::exchange(other.m_tracker, nullptr)) {}
+
+    Unit& operator=(const Unit& other) {
+        if (this != &other) {
+            retire();
+            m_name = other.m_name;
+            m_health = other.m_health;
+            m_events = other.m_events;
+            m_id = nextUnitId();
+            m_position = other.m_position;
+            m_heading = other.m_heading;
+            m_tracker = other.m_tracker;
+            m_events->nameUnit(m_id, m_name);
+            if (m_tracker)
+                m_tracker->moved(m_id, m_position);
+        }
+        return *this;
+    }
+
+    Unit& operator=(Unit&& other) noexcept {
+        if (this != &other) {
+            retire();
+            m_name = std::move(other.m_name);
+            m_health = other.m_health;
+            m_events = other.m_events;
+            m_id = std::exchange(other.m_id, kNoUnitId);
+            m_position = other.m_position;
+            m_heading = other.m_heading;
+            m_tracker = std::exchange(other.m_tracker, nullptr);
+        }
+        return *this;
+    }
 
     const std::string& getName() const { return m_name; }
+    std::uint32_t getId() const { return m_id; }
+    EventSink& getEvents() const { return *m_events; }
+    T getHealth() const { return m_health; }
+
+    const Position& getPosition() const { return m_position; }
+    const Position& getHeading() const { return m_heading; }
+
+    // Places the unit without counting as a move
+    void setPosition(const Position& position) {
+        m_position = position;
+        if (m_tracker)
+            m_tracker->moved(m_id, m_position);
+    }
+
+    // Direction of travel for move(); normalized here. A heading that is
+    // already unit length is kept bit-for-bit, so a restored unit moves exactly
+    // like the one that was saved.
+    void setHeading(const Position& heading) {
+        float length = std::sqrt(heading.x * heading.x + heading.y * heading.y + heading.z * heading.z);
+        if (std::fabs(length - 1.0f) <= 1e-6f)
+            m_heading = heading;
+        else if (length > 0)
+            m_heading = {heading.x / length, heading.y / length, heading.z / length};
+    }
+
+    // Reports this unit's position now and after every move; nullptr stops
+    // tracking. The tracker it leaves forgets it.
+    void trackWith(PositionTracker* tracker) {
+        if (m_tracker && m_tracker != tracker)
+            m_tracker->forget(m_id);
+        m_tracker = tracker;
+        if (m_tracker)
+            m_tracker->moved(m_id, m_position);
+    }
 
 protected:
+    // Moves the unit along its heading and tells the tracker
+    void advance(T distance) {
+        float step = static_cast<float>(distance);
+        m_position.x += m_heading.x * step;
+        m_position.y += m_heading.y * step;
+        m_position.z += m_heading.z * step;
+        if (m_tracker)
+            m_tracker->moved(m_id, m_position);
+    }
+
+    // Tells the sink and the tracker this id is done; a moved-from unit has no id left
+    void retire() {
+        if (m_id != kNoUnitId) {
+            if (m_tracker)
+                m_tracker->forget(m_id);
+            m_events->retireUnit(m_id);
+        }
+        m_id = kNoUnitId;
+        m_tracker = nullptr;
+    }
+
+    // Reports a move through the unit's event sink
+    void recordMove(T distance) {
+        m_events->record({m_id, 0, EventKind::Moved, static_cast<double>(distance)});
+    }
+
     std::string m_name;
     T m_health;
+    EventSink* m_events;
+    std::uint32_t m_id;
+    Position m_position;
+    Position m_heading{1, 0, 0};
+    PositionTracker* m_tracker = nullptr;
 };
 
 template <typename T>
 class Marine : public Unit<T>, public ResourceManager<T, Marine<T>> {
 public:
-    Marine(const std::string& name, T health, T ammo)
-            : Unit<T>(name, health), ResourceManager<T, Marine<T>>("ammo", ammo) {}
+    Marine(std::string name, T health, T ammo, EventSink& events = defaultEventSink())
+            : Unit<T>(std::move(name), health, events), ResourceManager<T, Marine<T>>("ammo", ammo) {}
 
     void move(T distance) override {
-        std::cout << this->m_name << " moved " << distance << " meters." << std::endl;
+        this->advance(distance);
+        this->recordMove(distance);
     }
 
     void action() override {
@@ -69,11 +212,12 @@ public:
 template <typename T>
 class Medic : public Unit<T>, public ResourceManager<T, Medic<T>> {
 public:
-    Medic(const std::string& name, T health, T medkits)
-            : Unit<T>(name, health), ResourceManager<T, Medic<T>>("medkit", medkits) {}
+    Medic(std::string name, T health, T medkits, EventSink& events = defaultEventSink())
+            : Unit<T>(std::move(name), health, events), ResourceManager<T, Medic<T>>("medkit", medkits) {}
 
     void move(T distance) override {
-        std::cout << this->m_name << " moved " << distance << " meters." << std::endl;
+        this->advance(distance);
+        this->recordMove(distance);
     }
 
     void action() override {
@@ -85,11 +229,12 @@ public:
 template <typename T>
 class Engineer : public Unit<T>, public ResourceManager<T, Engineer<T>> {
 public:
-    Engineer(const std::string& name, T health, T tools)
-            : Unit<T>(name, health), ResourceManager<T, Engineer<T>>("tool", tools) {}
+    Engineer(std::string name, T health, T tools, EventSink& events = defaultEventSink())
+            : Unit<T>(std::move(name), health, events), ResourceManager<T, Engineer<T>>("tool", tools) {}
 
     void move(T distance) override {
-        std::cout << this->m_name << " moved " << distance << " meters." << std::endl;
+        this->advance(distance);
+        this->recordMove(distance);
     }
 
     void action() override {
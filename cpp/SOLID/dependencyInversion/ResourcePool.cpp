@@ -0,0 +1,166 @@
+#pragma once
+/**
+ * @file ResourcePool.cpp
+ * @brief Shared squad/base supply pools that many units draw from concurrently.
+ *
+ * Phase 10: Shared supply
+ * A ResourceManager holds its own count and nothing refills it. SupplyPool is a
+ * stock of one resource shared by a squad or a base. Draws are lock-free: one
+ * compare-and-swap on an atomic counter that never goes below zero. A squad
+ * pool can name a parent (its base). When the squad pool runs dry it pulls a
+ * whole batch from the parent at once, so the base counter is touched once per
+ * batch rather than once per round.
+ *
+ * When many threads draw single units, even one atomic becomes a hot cache
+ * line. PoolAllotment is a per-thread cache in front of a pool: it takes a
+ * batch, hands units out locally, and returns what is left when destroyed.
+ * A ResourceManager can also refill itself from a pool in batches through
+ * supplyFrom(). Every refill of a pool or a unit is reported as a Resupplied
+ * event. Pools record events from whichever thread drew, so give them a
+ * thread-safe sink such as AsyncEventLog or NullEventSink.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "MissionEvents.cpp"
+
+class SupplyPool {
+public:
+    // The pool names itself to its sink like a unit, so its events read like a unit's
+    SupplyPool(std::string name, const std::string& resourceName, std::int64_t initialStock,
+               EventSink& events = defaultEventSink(), SupplyPool* parent = nullptr, std::int64_t refillBatch = 0)
+            : m_stock(initialStock), m_parent(parent), m_refillBatch(refillBatch), m_events(&events),
+              m_name(std::move(name)), m_id(nextUnitId()), m_resourceId(ResourceNames::idOf(resourceName)) {
+        m_events->nameUnit(m_id, m_name);
+    }
+
+    ~SupplyPool() { m_events->retireUnit(m_id); }
+
+    SupplyPool(const SupplyPool&) = delete;
+    SupplyPool& operator=(const SupplyPool&) = delete;
+
+    // Takes exactly amount, or nothing; returns what was taken. A non-positive amount takes nothing
+    std::int64_t draw(std::int64_t amount) {
+        if (amount <= 0)
+            return 0;
+        do {
+            std::int64_t stock = m_stock.load(std::memory_order_relaxed);
+            while (stock >= amount)
+                if (m_stock.compare_exchange_weak(stock, stock - amount, std::memory_order_acq_rel,
+                                                  std::memory_order_relaxed))
+                    return amount;
+        } while (refillFromParent());
+        return 0;
+    }
+
+    // Takes as much as is available, up to amount; a non-positive amount takes nothing
+    std::int64_t drawUpTo(std::int64_t amount) {
+        if (amount <= 0)
+            return 0;
+        do {
+            std::int64_t stock = m_stock.load(std::memory_order_relaxed);
+            while (stock > 0) {
+                std::int64_t take = std::min(stock, amount);
+                if (m_stock.compare_exchange_weak(stock, stock - take, std::memory_order_acq_rel,
+                                                  std::memory_order_relaxed))
+                    return take;
+            }
+        } while (refillFromParent());
+        return 0;
+    }
+
+    // Adds new stock and records a Resupplied event
+    void resupply(std::int64_t amount) {
+        m_stock.fetch_add(amount, std::memory_order_acq_rel);
+        m_resupplies.fetch_add(1, std::memory_order_relaxed);
+        m_events->record({m_id, m_resourceId, EventKind::Resupplied, static_cast<double>(amount)});
+    }
+
+    // Puts back units that were drawn but not used; not a resupply
+    void giveBack(std::int64_t amount) { m_stock.fetch_add(amount, std::memory_order_acq_rel); }
+
+    std::int64_t available() const { return m_stock.load(std::memory_order_acquire); }
+    std::uint64_t resupplyCount() const { return m_resupplies.load(std::memory_order_relaxed); }
+    SupplyPool* getParent() const { return m_parent; }
+    std::int64_t getRefillBatch() const { return m_refillBatch; }
+    const std::string& getName() const { return m_name; }
+    const std::string& getResourceName() const { return ResourceNames::name(m_resourceId); }
+    std::uint32_t getId() const { return m_id; }
+    std::uint16_t getResourceId() const { return m_resourceId; }
+
+private:
+    // Pulls one batch from the parent; false when there is none to pull
+    bool refillFromParent() {
+        if (!m_parent || m_refillBatch <= 0)
+            return false;
+        std::int64_t got = m_parent->drawUpTo(m_refillBatch);
+        if (got == 0)
+            return false;
+        resupply(got);
+        return true;
+    }
+
+    // Own cache line: the stock is the only field written on the hot path
+    alignas(64) std::atomic<std::int64_t> m_stock;
+    alignas(64) std::atomic<std::uint64_t> m_resupplies{0};
+    SupplyPool* m_parent;
+    std::int64_t m_refillBatch;
+    EventSink* m_events;
+    std::string m_name;
+    std::uint32_t m_id;
+    std::uint16_t m_resourceId;
+};
+
+// Per-thread cache of a pool's stock; not shared between threads
+class PoolAllotment {
+public:
+    PoolAllotment(SupplyPool& pool, std::int64_t batch) : m_pool(pool), m_batch(std::max<std::int64_t>(batch, 1)) {}
+    ~PoolAllotment() { release(); }
+
+    PoolAllotment(const PoolAllotment&) = delete;
+    PoolAllotment& operator=(const PoolAllotment&) = delete;
+
+    // Takes amount from the local cache, refilling it from the pool in batches
+    bool take(std::int64_t amount = 1) {
+        if (amount <= 0)
+            return false;
+        if (m_held < amount) {
+            m_held += m_pool.drawUpTo(std::max(m_batch, amount - m_held));
+            if (m_held < amount)
+                return false;
+        }
+        m_held -= amount;
+        return true;
+    }
+
+    // Returns the unused part of the allotment to the pool
+    void release() {
+        if (m_held > 0)
+            m_pool.giveBack(m_held);
+        m_held = 0;
+    }
+
+    std::int64_t held() const { return m_held; }
+
+private:
+    SupplyPool& m_pool;
+    std::int64_t m_batch;
+    std::int64_t m_held = 0;
+};
+
+/*
+int main() {
+    AsyncEventLog log(std::cout);
+    SupplyPool base("Base Camp", "ammo", 10000, log);
+    SupplyPool squad("Alpha Squad", "ammo", 0, log, &base, 500);
+
+    Marine<int> marine("John Doe", 100, 30, log);
+    marine.supplyFrom(&squad, 30);   // draws 30 rounds from the squad when empty
+    for (int i = 0; i < 100; ++i) marine.action();
+    log.flush();
+}
+*/
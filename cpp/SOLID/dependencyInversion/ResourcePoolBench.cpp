@@ -0,0 +1,123 @@
+/**
+ * @file ResourcePoolBench.cpp
+ * @brief Draws/sec on shared supply pools as the thread count grows.
+ *
+ * Usage: ResourcePoolBench [draws-per-thread] [max-threads]
+ * Every thread draws one unit at a time. Compared: a mutex-guarded counter,
+ * one SupplyPool shared by all threads, per-squad pools refilled from a base
+ * pool in batches, and PoolAllotment caches in front of one shared pool.
+ */
+
+#include <cstdlib>
+#include <atomic>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BenchUtil.cpp"
+#include "ResourcePool.cpp"
+
+// Baseline: one counter behind one lock
+class MutexPool {
+public:
+    explicit MutexPool(std::int64_t stock) : m_stock(stock) {}
+    bool draw() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stock == 0) return false;
+        --m_stock;
+        return true;
+    }
+    std::int64_t available() const { return m_stock; }
+
+private:
+    std::mutex m_mutex;
+    std::int64_t m_stock;
+};
+
+// Runs body(thread) on threads threads and returns draws/sec; body returns its successful draws
+double drawRate(std::size_t threads, std::size_t drawsPerThread, std::int64_t& granted,
+                const std::function<std::int64_t(std::size_t)>& body) {
+    std::vector<std::thread> workers;
+    std::atomic<std::int64_t> sum{0};
+    double ns = timeNs([&] {
+        for (std::size_t t = 0; t < threads; ++t) workers.emplace_back([&, t] { sum += body(t); });
+        for (auto& w : workers) w.join();
+    });
+    granted = sum;
+    return static_cast<double>(threads * drawsPerThread) / ns * 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t draws = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::size_t maxThreads = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                            : std::max(8u, std::thread::hardware_concurrency());
+    const std::size_t kSquads = 4;
+    NullEventSink quiet;
+    bool conserved = true;
+
+    std::cout << "M draws/s   threads       mutex      atomic      squads   allotment" << std::endl;
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        const std::int64_t total = static_cast<std::int64_t>(threads * draws);
+
+        MutexPool locked(total);
+        std::int64_t granted = 0;
+        double mutexRate = drawRate(threads, draws, granted, [&](std::size_t) {
+            std::int64_t n = 0;
+            for (std::size_t i = 0; i < draws; ++i) n += locked.draw();
+            return n;
+        });
+        conserved &= granted + locked.available() == total;
+
+        SupplyPool shared("Shared", "ammo", total, quiet);
+        double atomicRate = drawRate(threads, draws, granted, [&](std::size_t) {
+            std::int64_t n = 0;
+            for (std::size_t i = 0; i < draws; ++i) n += shared.draw(1);
+            return n;
+        });
+        conserved &= granted + shared.available() == total;
+
+        SupplyPool base("Base", "ammo", total, quiet);
+        std::vector<std::unique_ptr<SupplyPool>> squads;
+        for (std::size_t s = 0; s < kSquads; ++s)
+            squads.push_back(std::make_unique<SupplyPool>("Squad " + std::to_string(s), "ammo", 0, quiet, &base, 1024));
+        double squadRate = drawRate(threads, draws, granted, [&](std::size_t t) {
+            SupplyPool& squad = *squads[t % kSquads];
+            std::int64_t n = 0;
+            for (std::size_t i = 0; i < draws; ++i) n += squad.draw(1);
+            return n;
+        });
+        std::int64_t left = base.available();
+        for (auto& squad : squads) left += squad->available();
+        conserved &= granted + left == total;
+
+        SupplyPool cached("Cached", "ammo", total, quiet);
+        // Near the end a thread can find the pool empty while others still hold allotments
+        double allotmentRate = drawRate(threads, draws, granted, [&](std::size_t) {
+            PoolAllotment allotment(cached, 256);
+            std::int64_t n = 0;
+            for (std::size_t i = 0; i < draws; ++i) n += allotment.take();
+            return n;
+        });
+        conserved &= granted + cached.available() == total;
+
+        std::cout << std::fixed << std::setprecision(1) << std::setw(19) << threads << std::setw(12)
+                  << mutexRate / 1e6 << std::setw(12) << atomicRate / 1e6 << std::setw(12) << squadRate / 1e6
+                  << std::setw(12) << allotmentRate / 1e6 << std::endl;
+    }
+
+    // Negative or zero requests must not mint stock
+    SupplyPool guarded("Guarded", "ammo", 10, quiet);
+    conserved &= guarded.draw(-5) == 0 && guarded.drawUpTo(-5) == 0 && guarded.draw(0) == 0;
+    {
+        PoolAllotment allotment(guarded, 4);
+        conserved &= !allotment.take(-5);
+    }
+    conserved &= guarded.available() == 10;
+
+    std::cout << "stock conserved: " << (conserved ? "yes" : "NO") << std::endl;
+    return conserved ? 0 : 1;
+}
@@ -0,0 +1,343 @@
+#pragma once
+/**
+ * @file SpatialIndex.cpp
+ * @brief Unit positions and a uniform-grid spatial index for range queries.
+ *
+ * Phase 9: Positions and neighbour queries
+ * Units carry a 3D position and a heading; move(distance) advances them along
+ * the heading and reports the new position to a PositionTracker, and tell it
+ * to forget them when they are destroyed or stop being tracked. Unit<T>
+ * depends only on that interface, not on any particular index.
+ *
+ * SpatialGrid is such a tracker. It buckets units into square cells on the
+ * x/y plane (z takes part in distances but not in bucketing) and is updated
+ * incrementally: a move within a cell rewrites one entry, a move across a
+ * cell boundary is a swap-remove plus an append. Radius and k-nearest
+ * queries visit only the cells that can hold an answer. For mass movement,
+ * beginBatch()/endBatch() defers all cell work and rebuilds the buckets in
+ * one pass at the end. Inside a batch, moves may come from several threads,
+ * which is how a parallel performMission over tracked units must run.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct Position {
+    float x = 0;
+    float y = 0;
+    float z = 0;
+};
+
+inline float distanceSquared(const Position& a, const Position& b) {
+    float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Receives every position change of the units it tracks
+class PositionTracker {
+public:
+    virtual ~PositionTracker() = default;
+    virtual void moved(std::uint32_t unitId, const Position& position) = 0;
+    // The unit is gone or no longer tracked here; its id must not be reported again
+    virtual void forget(std::uint32_t unitId) = 0;
+};
+
+class SpatialGrid : public PositionTracker {
+public:
+    // cellSize is best close to the typical query radius
+    explicit SpatialGrid(float cellSize)
+            : m_cellSize(cellSize), m_inverseCell(1.0f / cellSize), m_gridId(nextGridId()) {}
+
+    SpatialGrid(const SpatialGrid&) = delete;
+    SpatialGrid& operator=(const SpatialGrid&) = delete;
+
+    // Inserts an unknown unit, otherwise moves it. Inside a batch this is
+    // safe to call from several threads, as long as no unit is moved by two
+    // threads at once; outside a batch it must not be called concurrently.
+    void moved(std::uint32_t unitId, const Position& position) override {
+        Record* record = find(unitId);
+        if (m_batching) {
+            if (record)
+                record->position = position;
+            else
+                localInserts().push_back({unitId, position});
+            return;
+        }
+        if (!record) {
+            append(unitId, insert(unitId, position), position);
+            return;
+        }
+        record->position = position;
+        // Most moves stay in their cell and skip the cell lookup entirely
+        if (coord(position.x) == record->cellX && coord(position.y) == record->cellY)
+            m_cells[record->cell][record->slot].position = position;
+        else {
+            unlink(*record);
+            append(unitId, *record, position);
+        }
+    }
+
+    // During a batch, only while no other thread is moving units
+    void remove(std::uint32_t unitId) {
+        if (m_batching) {
+            std::lock_guard<std::mutex> lock(m_insertsMutex);
+            for (auto& inserts : m_inserts)
+                inserts->erase(std::remove_if(inserts->begin(), inserts->end(),
+                                              [&](const Entry& e) { return e.unitId == unitId; }),
+                               inserts->end());
+        }
+        auto it = m_records.find(unitId);
+        if (it == m_records.end())
+            return;
+        if (!m_batching)
+            unlink(it->second);
+        m_records.erase(it);
+    }
+
+    void forget(std::uint32_t unitId) override { remove(unitId); }
+
+    bool contains(std::uint32_t unitId) const { return find(unitId) != nullptr; }
+
+    std::size_t size() const { return m_records.size(); }
+    const Position& positionOf(std::uint32_t unitId) const { return m_records.at(unitId).position; }
+
+    // Until endBatch(), moves only store positions and may come from several
+    // threads (see moved()); queries are not allowed. Wrap a parallel
+    // performMission over tracked units in a batch.
+    void beginBatch() { m_batching = true; }
+
+    // Adds the units first seen during the batch, then re-buckets every unit
+    // from its latest position
+    void endBatch() {
+        m_batching = false;
+        {
+            std::lock_guard<std::mutex> lock(m_insertsMutex);
+            for (auto& inserts : m_inserts) {
+                for (const Entry& e : *inserts) {
+                    if (Record* record = find(e.unitId))
+                        record->position = e.position;
+                    else
+                        insert(e.unitId, e.position);
+                }
+                inserts->clear();
+            }
+        }
+        rebuild();
+    }
+
+    // Calls fn(unitId, position) for every unit within radius of center
+    template <typename Fn>
+    void forEachInRadius(const Position& center, float radius, Fn&& fn) const {
+        const float r2 = radius * radius;
+        std::int64_t x0 = coord(center.x - radius), x1 = coord(center.x + radius);
+        std::int64_t y0 = coord(center.y - radius), y1 = coord(center.y + radius);
+        auto visit = [&](const std::vector<Entry>& cell) {
+            for (const Entry& e : cell)
+                if (distanceSquared(e.position, center) <= r2)
+                    fn(e.unitId, e.position);
+        };
+        // A huge radius covers more cells than exist; scanning them all is cheaper
+        if (double(x1 - x0 + 1) * double(y1 - y0 + 1) > double(m_cells.size())) {
+            for (const auto& cell : m_cells)
+                visit(cell);
+            return;
+        }
+        for (std::int64_t cy = y0; cy <= y1; ++cy)
+            for (std::int64_t cx = x0; cx <= x1; ++cx) {
+                auto it = m_cellIndex.find(key(cx, cy));
+                if (it != m_cellIndex.end())
+                    visit(m_cells[it->second]);
+            }
+    }
+
+    std::vector<std::uint32_t> queryRadius(const Position& center, float radius) const {
+        std::vector<std::uint32_t> found;
+        forEachInRadius(center, radius, [&](std::uint32_t id, const Position&) { found.push_back(id); });
+        return found;
+    }
+
+    // Up to k unit ids, nearest first. Searches square rings of cells outward
+    // and stops once no unvisited cell can hold anything closer.
+    std::vector<std::uint32_t> nearest(const Position& center, std::size_t k) const {
+        std::vector<std::uint32_t> result;
+        if (k == 0 || m_records.empty())
+            return result;
+        using Candidate = std::pair<float, std::uint32_t>;
+        std::priority_queue<Candidate> best;  // max-heap: the worst of the k best on top
+        auto visitCell = [&](const std::vector<Entry>& cell) {
+            for (const Entry& e : cell) {
+                float d2 = distanceSquared(e.position, center);
+                if (best.size() < k)
+                    best.emplace(d2, e.unitId);
+                else if (d2 < best.top().first) {
+                    best.pop();
+                    best.emplace(d2, e.unitId);
+                }
+            }
+        };
+        auto visit = [&](std::int64_t cx, std::int64_t cy) {
+            if (cx < m_minCell[0] || cx > m_maxCell[0] || cy < m_minCell[1] || cy > m_maxCell[1])
+                return;
+            auto it = m_cellIndex.find(key(cx, cy));
+            if (it != m_cellIndex.end())
+                visitCell(m_cells[it->second]);
+        };
+        const std::int64_t cx = coord(center.x), cy = coord(center.y);
+        const std::int64_t reach = std::max({cx - m_minCell[0], m_maxCell[0] - cx, cy - m_minCell[1], m_maxCell[1] - cy});
+        for (std::int64_t ring = 0; ring <= reach; ++ring) {
+            // Sparse grids: once a ring spans more cells than exist, scan them all instead
+            if (double(8 * ring) > double(m_cells.size())) {
+                best = {};
+                for (const auto& cell : m_cells)
+                    visitCell(cell);
+                break;
+            }
+            if (ring == 0)
+                visit(cx, cy);
+            else
+                for (std::int64_t i = -ring; i <= ring; ++i) {
+                    visit(cx + i, cy - ring);
+                    visit(cx + i, cy + ring);
+                    if (i != -ring && i != ring) {
+                        visit(cx - ring, cy + i);
+                        visit(cx + ring, cy + i);
+                    }
+                }
+            // Everything outside this ring is at least ring * cellSize away
+            float bound = float(ring) * m_cellSize;
+            if (best.size() == k && best.top().first <= bound * bound)
+                break;
+        }
+        result.resize(best.size());
+        for (std::size_t i = result.size(); i-- > 0; best.pop())
+            result[i] = best.top().second;
+        return result;
+    }
+
+private:
+    struct Entry {
+        std::uint32_t unitId;
+        Position position;
+    };
+
+    // Where a unit is stored; position is the latest one reported
+    struct Record {
+        Position position;
+        std::uint32_t cell = 0;
+        std::uint32_t slot = 0;
+        std::int32_t cellX = 0;
+        std::int32_t cellY = 0;
+    };
+
+    static std::uint64_t nextGridId() {
+        static std::atomic<std::uint64_t> next{1};
+        return next.fetch_add(1);
+    }
+
+    // Cell coordinate, clamped so positions far out or NaN stay defined
+    std::int32_t coord(float v) const {
+        float c = std::floor(v * m_inverseCell);
+        if (!(c > -2147483648.0f))
+            return std::numeric_limits<std::int32_t>::min();
+        if (c >= 2147483648.0f)
+            return std::numeric_limits<std::int32_t>::max();
+        return static_cast<std::int32_t>(c);
+    }
+
+    static std::uint64_t key(std::int64_t cx, std::int64_t cy) {
+        return (std::uint64_t(std::uint32_t(cx)) << 32) | std::uint32_t(cy);
+    }
+
+    // Unit ids are global and never reused, so records are keyed by id
+    // rather than indexed by it. Records never move once inserted, and
+    // finding one only reads the table, so batched moves from several
+    // threads can look up and write their own records side by side.
+    Record* find(std::uint32_t unitId) {
+        auto it = m_records.find(unitId);
+        return it == m_records.end() ? nullptr : &it->second;
+    }
+
+    const Record* find(std::uint32_t unitId) const {
+        auto it = m_records.find(unitId);
+        return it == m_records.end() ? nullptr : &it->second;
+    }
+
+    Record& insert(std::uint32_t unitId, const Position& position) {
+        Record& record = m_records[unitId];
+        record.position = position;
+        return record;
+    }
+
+    // This thread's buffer of units first seen during a batch. Grids are told
+    // apart by id, not address, so a new grid never picks up a stale buffer.
+    std::vector<Entry>& localInserts() {
+        thread_local std::vector<std::pair<std::uint64_t, std::vector<Entry>*>> cache;
+        for (auto& entry : cache)
+            if (entry.first == m_gridId)
+                return *entry.second;
+        std::lock_guard<std::mutex> lock(m_insertsMutex);
+        m_inserts.push_back(std::make_unique<std::vector<Entry>>());
+        cache.emplace_back(m_gridId, m_inserts.back().get());
+        return *m_inserts.back();
+    }
+
+    // Cell index for a position, creating the cell on first use
+    std::uint32_t cellFor(const Position& p) {
+        std::int32_t cx = coord(p.x), cy = coord(p.y);
+        auto inserted = m_cellIndex.emplace(key(cx, cy), std::uint32_t(m_cells.size()));
+        if (inserted.second) {
+            m_cells.emplace_back();
+            m_minCell[0] = std::min(m_minCell[0], cx);
+            m_maxCell[0] = std::max(m_maxCell[0], cx);
+            m_minCell[1] = std::min(m_minCell[1], cy);
+            m_maxCell[1] = std::max(m_maxCell[1], cy);
+        }
+        return inserted.first->second;
+    }
+
+    void append(std::uint32_t unitId, Record& record, const Position& p) {
+        std::uint32_t cell = cellFor(p);
+        record.cell = cell;
+        record.cellX = coord(p.x);
+        record.cellY = coord(p.y);
+        record.slot = std::uint32_t(m_cells[cell].size());
+        m_cells[cell].push_back({unitId, p});
+    }
+
+    // Swap-remove from the unit's cell, fixing the slot of the entry moved into its place
+    void unlink(const Record& record) {
+        std::vector<Entry>& cell = m_cells[record.cell];
+        cell[record.slot] = cell.back();
+        m_records.find(cell[record.slot].unitId)->second.slot = record.slot;
+        cell.pop_back();
+    }
+
+    void rebuild() {
+        for (auto& cell : m_cells)
+            cell.clear();
+        for (auto& [unitId, record] : m_records)
+            append(unitId, record, record.position);
+    }
+
+    float m_cellSize;
+    float m_inverseCell;
+    std::uint64_t m_gridId;
+    std::unordered_map<std::uint64_t, std::uint32_t> m_cellIndex;
+    std::vector<std::vector<Entry>> m_cells;
+    std::unordered_map<std::uint32_t, Record> m_records;
+    std::int32_t m_minCell[2] = {std::numeric_limits<std::int32_t>::max(), std::numeric_limits<std::int32_t>::max()};
+    std::int32_t m_maxCell[2] = {std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::min()};
+    bool m_batching = false;
+    std::mutex m_insertsMutex;
+    std::vector<std::unique_ptr<std::vector<Entry>>> m_inserts;
+};
@@ -0,0 +1,166 @@
+/**
+ * @file SpatialIndexBench.cpp
+ * @brief Update and query throughput of SpatialGrid.
+ *
+ * Usage: SpatialIndexBench [positions] [units] [queries]
+ * positions: entries moved directly through the grid (default 10^6)
+ * units:     Marines moved through Unit<T>::move (default 10^5)
+ * Results of a sample of queries are checked against a brute-force scan.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchUtil.cpp"
+#include "ParallelMission.cpp"
+#include "ResourceMgmtUnitTemplate.cpp"
+
+int main(int argc, char* argv[]) {
+    const std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::size_t unitCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    const std::size_t queries = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100000;
+
+    // About four units per 10x10 cell, whatever the count
+    const float side = 5.0f * std::sqrt(static_cast<float>(count));
+    const float radius = 10.0f;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coord(0.0f, side), jitter(-1.0f, 1.0f);
+
+    std::vector<Position> positions(count);
+    for (auto& p : positions)
+        p = {coord(rng), coord(rng), 0.0f};
+
+    SpatialGrid grid(radius);
+    reportNs("insert", timeNs([&] {
+        for (std::uint32_t id = 0; id < count; ++id)
+            grid.moved(id, positions[id]);
+    }), count, "unit");
+
+    reportNs("incremental move", timeNs([&] {
+        for (std::uint32_t id = 0; id < count; ++id) {
+            positions[id].x += jitter(rng);
+            positions[id].y += jitter(rng);
+            grid.moved(id, positions[id]);
+        }
+    }), count, "unit");
+
+    reportNs("batch move + rebuild", timeNs([&] {
+        grid.beginBatch();
+        for (std::uint32_t id = 0; id < count; ++id) {
+            positions[id].x += jitter(rng);
+            positions[id].y += jitter(rng);
+            grid.moved(id, positions[id]);
+        }
+        grid.endBatch();
+    }), count, "unit");
+
+    std::vector<Position> centers(queries);
+    for (auto& c : centers)
+        c = {coord(rng), coord(rng), 0.0f};
+    std::size_t hits = 0;
+    reportNs("radius query", timeNs([&] {
+        for (const auto& c : centers)
+            grid.forEachInRadius(c, radius, [&](std::uint32_t, const Position&) { ++hits; });
+    }), queries, "query");
+    std::size_t kHits = 0;
+    reportNs("8-nearest query", timeNs([&] {
+        for (const auto& c : centers)
+            kHits += grid.nearest(c, 8).size();
+    }), queries, "query");
+    std::cout << "  " << double(hits) / double(queries) << " units per radius query, "
+              << double(kHits) / double(queries) << " per kNN query" << std::endl;
+
+    // Brute-force check of a few queries
+    std::size_t mismatches = 0;
+    for (std::size_t q = 0; q < std::min<std::size_t>(queries, 50); ++q) {
+        std::vector<std::uint32_t> expected;
+        std::vector<std::pair<float, std::uint32_t>> byDistance;
+        for (std::uint32_t id = 0; id < count; ++id) {
+            float d2 = distanceSquared(positions[id], centers[q]);
+            if (d2 <= radius * radius)
+                expected.push_back(id);
+            byDistance.emplace_back(d2, id);
+        }
+        auto found = grid.queryRadius(centers[q], radius);
+        std::sort(found.begin(), found.end());
+        mismatches += found != expected;
+        std::partial_sort(byDistance.begin(), byDistance.begin() + 8, byDistance.end());
+        auto nearest = grid.nearest(centers[q], 8);
+        for (std::size_t i = 0; i < nearest.size(); ++i)
+            mismatches += distanceSquared(positions[nearest[i]], centers[q]) != byDistance[i].first;
+    }
+    std::cout << "  brute-force check: " << (mismatches ? "MISMATCH" : "ok") << std::endl;
+
+    // Units report their own moves to the grid they are tracked by
+    NullEventSink quiet;
+    SpatialGrid unitGrid(radius);
+    std::vector<std::unique_ptr<Marine<int>>> marines;
+    marines.reserve(unitCount);
+    for (std::size_t i = 0; i < unitCount; ++i) {
+        marines.push_back(std::make_unique<Marine<int>>("Marine " + std::to_string(i), 100, 30, quiet));
+        marines.back()->setPosition({coord(rng), coord(rng), 0.0f});
+        marines.back()->setHeading({jitter(rng), jitter(rng), 0.0f});
+        marines.back()->trackWith(&unitGrid);
+    }
+    reportNs("Marine::move, tracked", timeNs([&] {
+        for (auto& marine : marines)
+            marine->move(1);
+    }), unitCount, "unit");
+    reportNs("Marine::move, batched", timeNs([&] {
+        unitGrid.beginBatch();
+        for (auto& marine : marines)
+            marine->move(1);
+        unitGrid.endBatch();
+    }), unitCount, "unit");
+
+    // Parallel missions over tracked units run inside a batch
+    WorkStealingPool pool(4);
+    std::vector<Unit<int>*> units;
+    for (auto& marine : marines)
+        units.push_back(marine.get());
+    reportNs("parallel mission, batched", timeNs([&] {
+        unitGrid.beginBatch();
+        performMission(pool, units, 1, 1024);
+        unitGrid.endBatch();
+    }), unitCount, "unit");
+    std::size_t stale = 0;
+    for (auto* unit : units) {
+        const Position& tracked = unitGrid.positionOf(unit->getId());
+        const Position& actual = unit->getPosition();
+        stale += tracked.x != actual.x || tracked.y != actual.y || tracked.z != actual.z;
+    }
+    std::cout << "  tracked positions after parallel mission: " << (stale ? "STALE" : "ok") << std::endl;
+    mismatches += stale;
+
+    // Destroyed units leave the grid; queries return only live ids
+    std::vector<std::uint32_t> liveIds;
+    units.clear();
+    for (std::size_t i = 0; i < marines.size(); ++i) {
+        if (i % 2)
+            marines[i].reset();
+        else
+            liveIds.push_back(marines[i]->getId());
+    }
+    auto everyone = unitGrid.queryRadius({side / 2, side / 2, 0.0f}, 4 * side);
+    std::sort(everyone.begin(), everyone.end());
+    std::sort(liveIds.begin(), liveIds.end());
+    bool forgotten = unitGrid.size() == liveIds.size() && everyone == liveIds;
+    std::cout << "  after destroying half the units: " << (forgotten ? "ok" : "DEAD IDS TRACKED") << std::endl;
+    mismatches += !forgotten;
+
+    // Positions and radii far outside the int32 cell range are clamped, not undefined
+    SpatialGrid farGrid(1.0f);
+    farGrid.moved(0, {3e30f, -3e30f, 0.0f});
+    farGrid.moved(1, {-3e30f, 3e30f, 0.0f});
+    farGrid.moved(2, {0.0f, 0.0f, 0.0f});
+    std::size_t farHits = farGrid.queryRadius({0.0f, 0.0f, 0.0f}, 1e31f).size();
+    std::size_t farNearest = farGrid.nearest({3e30f, -3e30f, 0.0f}, 3).size();
+    std::cout << "  far positions: " << farHits << " in radius, " << farNearest << " nearest" << std::endl;
+    mismatches += farHits != 3 || farNearest != 3;
+    return mismatches ? 1 : 0;
+}
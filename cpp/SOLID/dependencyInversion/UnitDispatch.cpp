@@ -0,0 +1,89 @@
+#pragma once
+/**
+ * @file UnitDispatch.cpp
+ * @brief Compile-time dispatch for the closed set of unit types.
+ *
+ * Phase 6: Devirtualized dispatch
+ * Marine, Medic and Engineer are the only units, and each already knows its
+ * own type through ResourceManager<T, DerivedClass>. Two containers use that:
+ *   - UnitVariant<T> holds any unit by value; std::visit picks the type.
+ *   - UnitSquads<T> keeps one homogeneous vector per type.
+ * Both call move()/action() with a qualified name (u.Marine<T>::move), which
+ * bypasses the vtable so useResource() can be inlined into the mission loop.
+ * The Unit<T>* path in ResourceMgmtUnitTemplate.cpp is unchanged.
+ */
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "ResourceMgmtUnitTemplate.cpp"
+
+template <typename T>
+using UnitVariant = std::variant<Marine<T>, Medic<T>, Engineer<T>>;
+
+// Runs one mission step on a unit whose concrete type is known statically
+template <typename U, typename T>
+inline void runUnit(U& unit, T moveDistance) {
+    unit.U::move(moveDistance);
+    unit.U::action();
+}
+
+// Per-type homogeneous storage; every loop over a squad has a single type
+template <typename T>
+class UnitSquads {
+public:
+    template <typename U>
+    U& add(U unit) {
+        auto& squad = std::get<std::vector<U>>(m_squads);
+        squad.push_back(std::move(unit));
+        return squad.back();
+    }
+
+    template <typename U>
+    std::vector<U>& squad() { return std::get<std::vector<U>>(m_squads); }
+
+    // Calls fn once per squad with the concrete vector type
+    template <typename Fn>
+    void forEachSquad(Fn&& fn) {
+        std::apply([&](auto&... squads) { (fn(squads), ...); }, m_squads);
+    }
+
+    std::size_t size() const {
+        return std::apply([](const auto&... squads) { return (squads.size() + ...); }, m_squads);
+    }
+
+private:
+    std::tuple<std::vector<Marine<T>>, std::vector<Medic<T>>, std::vector<Engineer<T>>> m_squads;
+};
+
+// performMission over units held by value in a variant
+template <typename T>
+void performMission(std::vector<UnitVariant<T>>& units, T moveDistance) {
+    for (auto& unit : units)
+        std::visit([moveDistance](auto& u) { runUnit(u, moveDistance); }, unit);
+}
+
+// performMission one squad at a time
+template <typename T>
+void performMission(UnitSquads<T>& squads, T moveDistance) {
+    squads.forEachSquad([moveDistance](auto& squad) {
+        for (auto& u : squad) runUnit(u, moveDistance);
+    });
+}
+
+/*
+ * int main() {
+    std::vector<UnitVariant<int>> units;
+    units.emplace_back(Marine<int>("John Doe", 100, 30));
+    units.emplace_back(Medic<int>("Jane Smith", 80, 5));
+    performMission(units, 50);
+
+    UnitSquads<int> squads;
+    squads.add(Engineer<int>("Bob Builder", 90, 10));
+    performMission(squads, 50);
+    return 0;
+}
+ */
@@ -0,0 +1,60 @@
+/**
+ * @file UnitDispatchBench.cpp
+ * @brief ns/unit for virtual, variant and per-type squad dispatch.
+ *
+ * Usage: UnitDispatchBench [units] [ticks]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BenchUtil.cpp"
+#include "UnitDispatch.cpp"
+
+int main(int argc, char* argv[]) {
+    const std::size_t unitCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 300000;
+    const int ticks = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    // Quiet sink so the timings show dispatch, not formatting
+    NullEventSink quiet;
+    std::vector<Unit<int>*> pointers;
+    std::vector<UnitVariant<int>> variants;
+    UnitSquads<int> squads;
+    pointers.reserve(unitCount);
+    variants.reserve(unitCount);
+    for (std::size_t i = 0; i < unitCount; ++i) {
+        std::string name = "Unit " + std::to_string(i);
+        switch (i % 3) {
+            case 0:
+                pointers.push_back(new Marine<int>(name, 100, 30, quiet));
+                variants.emplace_back(Marine<int>(name, 100, 30, quiet));
+                squads.add(Marine<int>(name, 100, 30, quiet));
+                break;
+            case 1:
+                pointers.push_back(new Medic<int>(name, 80, 5, quiet));
+                variants.emplace_back(Medic<int>(name, 80, 5, quiet));
+                squads.add(Medic<int>(name, 80, 5, quiet));
+                break;
+            default:
+                pointers.push_back(new Engineer<int>(name, 90, 10, quiet));
+                variants.emplace_back(Engineer<int>(name, 90, 10, quiet));
+                squads.add(Engineer<int>(name, 90, 10, quiet));
+                break;
+        }
+    }
+
+    double virtualNs = timeNs([&] { for (int t = 0; t < ticks; ++t) performMission(pointers, 50); });
+    double variantNs = timeNs([&] { for (int t = 0; t < ticks; ++t) performMission(variants, 50); });
+    double squadNs = timeNs([&] { for (int t = 0; t < ticks; ++t) performMission(squads, 50); });
+
+    const std::size_t steps = unitCount * ticks;
+    std::cout << unitCount << " units, " << ticks << " ticks" << std::endl;
+    reportNs("virtual  ", virtualNs, steps);
+    reportNs("variant  ", variantNs, steps);
+    reportNs("per-type ", squadNs, steps);
+
+    for (auto unit : pointers) delete unit;
+    return 0;
+}
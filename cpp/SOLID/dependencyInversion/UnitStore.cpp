@@ -0,0 +1,148 @@
+#pragma once
+/**
+ * @file UnitStore.cpp
+ * @brief Structure-of-arrays storage for Marine/Medic/Engineer squads.
+ *
+ * Phase 4: Data-oriented unit storage
+ * performMission over a std::vector<Unit<T>*> touches one heap object per unit
+ * and makes two virtual calls on it. UnitStore keeps the same state (name,
+ * health, position and the ResourceManager count) in contiguous per-type
+ * columns, so a mission tick is a handful of linear passes the compiler can
+ * vectorize. Names are stored once and referenced from the columns by handle.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ResourceMgmtUnitTemplate.cpp"
+
+enum class UnitKind : std::uint8_t { Marine, Medic, Engineer };
+
+constexpr std::size_t kUnitKindCount = 3;
+
+// Resource used by each kind, matching the ResourceManager names
+inline const char* resourceNameOf(UnitKind kind) {
+    switch (kind) {
+        case UnitKind::Marine:   return "ammo";
+        case UnitKind::Medic:    return "medkit";
+        case UnitKind::Engineer: return "tool";
+    }
+    return "";
+}
+
+// One column per attribute; row i across all columns is one unit
+template <typename T>
+struct UnitColumns {
+    std::vector<std::uint32_t> nameIds;
+    std::vector<T> health;
+    std::vector<T> position;
+    std::vector<T> resources;
+
+    std::size_t size() const { return nameIds.size(); }
+
+    void reserve(std::size_t n) {
+        nameIds.reserve(n);
+        health.reserve(n);
+        position.reserve(n);
+        resources.reserve(n);
+    }
+};
+
+// Aggregate outcome of a batched mission tick
+struct MissionReport {
+    std::size_t unitsMoved = 0;
+    std::size_t resourcesUsed = 0;
+    std::size_t outOfResource = 0;
+};
+
+template <typename T>
+class UnitStore {
+public:
+    using Handle = std::uint32_t;
+
+    void reserve(UnitKind kind, std::size_t n) { columns(kind).reserve(n); }
+
+    Handle addMarine(const std::string& name, T health, T ammo) {
+        return add(UnitKind::Marine, name, health, ammo);
+    }
+
+    Handle addMedic(const std::string& name, T health, T medkits) {
+        return add(UnitKind::Medic, name, health, medkits);
+    }
+
+    Handle addEngineer(const std::string& name, T health, T tools) {
+        return add(UnitKind::Engineer, name, health, tools);
+    }
+
+    UnitColumns<T>& columns(UnitKind kind) { return m_columns[static_cast<std::size_t>(kind)]; }
+    const UnitColumns<T>& columns(UnitKind kind) const { return m_columns[static_cast<std::size_t>(kind)]; }
+
+    const std::string& getName(UnitKind kind, Handle row) const {
+        return m_names[columns(kind).nameIds[row]];
+    }
+
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const auto& cols : m_columns) total += cols.size();
+        return total;
+    }
+
+private:
+    Handle add(UnitKind kind, const std::string& name, T health, T resources) {
+        auto& cols = columns(kind);
+        cols.nameIds.push_back(static_cast<std::uint32_t>(m_names.size()));
+        cols.health.push_back(health);
+        cols.position.push_back(T{});
+        cols.resources.push_back(resources);
+        m_names.push_back(name);
+        return static_cast<Handle>(cols.size() - 1);
+    }
+
+    std::vector<std::string> m_names;
+    std::array<UnitColumns<T>, kUnitKindCount> m_columns;
+};
+
+// Batched counterpart of performMission: every unit moves, then every unit
+// uses one of its resources. Results are aggregated instead of printed.
+template <typename T>
+MissionReport performMission(UnitStore<T>& store, T moveDistance) {
+    MissionReport report;
+    for (std::size_t k = 0; k < kUnitKindCount; ++k) {
+        auto& cols = store.columns(static_cast<UnitKind>(k));
+        const std::size_t n = cols.size();
+
+        T* position = cols.position.data();
+        for (std::size_t i = 0; i < n; ++i)
+            position[i] += moveDistance;
+
+        // Branch-free decrement keeps the loop vectorizable
+        T* resources = cols.resources.data();
+        std::size_t used = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const bool has = resources[i] > T{};
+            resources[i] -= static_cast<T>(has);
+            used += has;
+        }
+
+        report.unitsMoved += n;
+        report.resourcesUsed += used;
+        report.outOfResource += n - used;
+    }
+    return report;
+}
+
+/*
+ * int main() {
+    UnitStore<int> store;
+    store.addMarine("John Doe", 100, 30);
+    store.addMedic("Jane Smith", 80, 5);
+    store.addEngineer("Bob Builder", 90, 10);
+
+    MissionReport report = performMission(store, 50);
+    std::cout << report.resourcesUsed << " resources used" << std::endl;
+    return 0;
+}
+ */
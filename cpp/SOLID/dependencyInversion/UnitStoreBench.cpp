@@ -0,0 +1,62 @@
+/**
+ * @file UnitStoreBench.cpp
+ * @brief Compares performMission over Unit<T>* with the UnitStore<T> overload.
+ *
+ * Usage: UnitStoreBench [units] [ticks]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BenchUtil.cpp"
+#include "UnitStore.cpp"
+
+int main(int argc, char* argv[]) {
+    const std::size_t unitCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 300000;
+    const int ticks = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::vector<Unit<int>*> units;
+    UnitStore<int> store;
+    units.reserve(unitCount);
+    for (std::size_t i = 0; i < unitCount; ++i) {
+        std::string name = "Unit " + std::to_string(i);
+        switch (i % 3) {
+            case 0:
+                units.push_back(new Marine<int>(name, 100, 30));
+                store.addMarine(name, 100, 30);
+                break;
+            case 1:
+                units.push_back(new Medic<int>(name, 80, 5));
+                store.addMedic(name, 80, 5);
+                break;
+            default:
+                units.push_back(new Engineer<int>(name, 90, 10));
+                store.addEngineer(name, 90, 10);
+                break;
+        }
+    }
+
+    double pointerNs = 0;
+    {
+        SilenceCout quiet;
+        pointerNs = timeNs([&] {
+            for (int t = 0; t < ticks; ++t) performMission(units, 50);
+        });
+    }
+
+    MissionReport report;
+    double storeNs = timeNs([&] {
+        for (int t = 0; t < ticks; ++t) report = performMission(store, 50);
+    });
+
+    std::cout << unitCount << " units, " << ticks << " ticks" << std::endl;
+    reportNs("vector<Unit<T>*>", pointerNs, unitCount * ticks);
+    reportNs("UnitStore<T>    ", storeNs, unitCount * ticks);
+    std::cout << "last tick: " << report.resourcesUsed << " used, "
+              << report.outOfResource << " out of resource" << std::endl;
+
+    for (auto unit : units) delete unit;
+    return 0;
+}
@@ -8,30 +8,45 @@
  */
 // TODO: Implement this class
 
-#include <iostream>
 #include <string>
 #include <vector>
 
+#include "MissionEvents.cpp"
+
 using namespace std;
 
+// Units report through an EventSink instead of writing to cout
 template <typename T> class UnitTemplate {
 public:
-    UnitTemplate(const string& name, T health) : m_name, m_health(health) {}
+    UnitTemplate(const string& name, T health, EventSink& events = defaultEventSink())
+            : m_name(name), m_health(health), m_events(&events), m_id(nextUnitId()) {
+        m_events->nameUnit(m_id, m_name);
+    }
     virtual void move(T distance) = 0;
     virtual void action() = 0;
-    virtual ~UnitTemplate() = default;
+    virtual ~UnitTemplate() { m_events->retireUnit(m_id); }
+
+    UnitTemplate(const UnitTemplate&) = delete;
+    UnitTemplate& operator=(const UnitTemplate&) = delete;
 
 protected:
+    void report(EventKind kind, std::uint16_t resourceId, double value) {
+        m_events->record({m_id, resourceId, kind, value});
+    }
+
     string m_name;
     T m_health;
+    EventSink* m_events;
+    std::uint32_t m_id;
 };
 
-template  <typename T> class Marine : public Unit<T> {
+template  <typename T> class Marine : public UnitTemplate<T> {
 public:
-    Marine(const string& name, T health, T ammo) : Unit<T>(name, health), m_ammo(ammo) {}
+    Marine(const string& name, T health, T ammo, EventSink& events = defaultEventSink())
+            : UnitTemplate<T>(name, health, events), m_ammo(ammo) {}
 
     void move(T distance) override {
-        cout << this->m_name << " moved " << distance << " meters. " << endl;
+        this->report(EventKind::Moved, 0, static_cast<double>(distance));
     }
 
     void action() override {
@@ -40,11 +55,12 @@ public:
 
 private:
     void shoot(){
+        static const std::uint16_t ammoId = ResourceNames::idOf("ammo");
         if(m_ammo > 0) {
             m_ammo--;
-            cout << this->m_name << " fired a shot.  Ammo left: " << endl;
+            this->report(EventKind::UsedResource, ammoId, static_cast<double>(m_ammo));
         } else {
-            cout << this->m_name << " is out of ammo!! " << endl;
+            this->report(EventKind::OutOfResource, ammoId, 0);
         }
     }
 
@@ -53,13 +69,13 @@ private:
 
 // New class utilizing the template
 template <typename T>
-class Medic : public Unit<T> {
+class Medic : public UnitTemplate<T> {
 public:
-    Medic(const std::string& name, T health, T medkits)
-            : Unit<T>(name, health), m_medkits(medkits) {}
+    Medic(const std::string& name, T health, T medkits, EventSink& events = defaultEventSink())
+            : UnitTemplate<T>(name, health, events), m_medkits(medkits) {}
 
     void move(T distance) override {
-        std::cout << this->m_name << " moved " << distance << " meters." << std::endl;
+        this->report(EventKind::Moved, 0, static_cast<double>(distance));
     }
 
     void action() override {
@@ -68,11 +84,12 @@ public:
 
 private:
     void heal() {
+        static const std::uint16_t medkitId = ResourceNames::idOf("medkit");
         if (m_medkits > 0) {
             m_medkits--;
-            std::cout << this->m_name << " used a medkit. Medkits left: " << m_medkits << std::endl;
+            this->report(EventKind::UsedResource, medkitId, static_cast<double>(m_medkits));
         } else {
-            std::cout << this->m_name << " is out of medkits!" << std::endl;
+            this->report(EventKind::OutOfResource, medkitId, 0);
         }
     }
 
@@ -81,7 +98,7 @@ private:
 
 // Template function for unit actions
 template <typename T>
-void performMission(std::vector<Unit<T>*>& units, T moveDistance) {
+void performMission(std::vector<UnitTemplate<T>*>& units, T moveDistance) {
     for (auto unit : units) {
         unit->move(moveDistance);
         unit->action();
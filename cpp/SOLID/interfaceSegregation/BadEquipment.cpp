@@ -0,0 +1,91 @@
+#pragma once
+// bad design - violating ISP: one fat interface, unsupported uses throw
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace bad_design {
+
+
+class Equipment {
+public:
+    virtual void use_as_weapon() = 0;
+    virtual void use_for_navigation() = 0;
+    virtual void use_for_communication() = 0;
+    virtual void use_for_survival() = 0;
+    virtual ~Equipment() = default;
+};
+
+class Rifle : public Equipment {
+public:
+    void use_as_weapon() override;
+    void use_for_navigation() override;
+    void use_for_communication() override;
+    void use_for_survival() override;
+};
+
+class Compass : public Equipment {
+public:
+    void use_as_weapon() override;
+    void use_for_navigation() override;
+    void use_for_communication() override;
+    void use_for_survival() override;
+};
+
+class Radio : public Equipment {
+public:
+    void use_as_weapon() override;
+    void use_for_navigation() override;
+    void use_for_communication() override;
+    void use_for_survival() override;
+};
+
+inline void Rifle::use_as_weapon() {
+    std::cout << "Using rifle to engage target" << std::endl;
+}
+
+inline void Rifle::use_for_navigation() {
+    throw std::runtime_error("Rifle cannot be used for navigation");
+}
+
+inline void Rifle::use_for_communication() {
+    throw std::runtime_error("Rifle cannot be used for communication");
+}
+
+inline void Rifle::use_for_survival() {
+    std::cout << "Using rifle to hunt for food" << std::endl;
+}
+
+inline void Compass::use_as_weapon() {
+    throw std::runtime_error("Compass cannot be used as a weapon");
+}
+
+inline void Compass::use_for_navigation() {
+    std::cout << "Using compass to determine direction" << std::endl;
+}
+
+inline void Compass::use_for_communication() {
+    throw std::runtime_error("Compass cannot be used for communication");
+}
+
+inline void Compass::use_for_survival() {
+    std::cout << "Using compass to find way back to safety" << std::endl;
+}
+
+inline void Radio::use_as_weapon() {
+    throw std::runtime_error("Radio cannot be used as a weapon");
+}
+
+inline void Radio::use_for_navigation() {
+    throw std::runtime_error("Radio cannot be used for navigation");
+}
+
+inline void Radio::use_for_communication() {
+    std::cout << "Using radio to call for support" << std::endl;
+}
+
+inline void Radio::use_for_survival() {
+    std::cout << "Using radio to call for rescue" << std::endl;
+}
+
+} // namespace bad_design
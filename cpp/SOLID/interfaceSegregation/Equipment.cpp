@@ -0,0 +1,70 @@
+#pragma once
+// Segregated equipment interfaces: each item implements only what it can do
+#include <iostream>
+#include <string>
+
+class Weapon {
+public:
+    virtual void use_as_weapon() = 0;
+    virtual ~Weapon() = default;
+};
+
+class NavigationTool {
+public:
+    virtual void use_for_navigation() = 0;
+    virtual ~NavigationTool() = default;
+};
+
+class CommunicationTool {
+public:
+    virtual void use_for_communication() = 0;
+    virtual ~CommunicationTool() = default;
+};
+
+class SurvivalTool {
+public:
+    virtual void use_for_survival() = 0;
+    virtual ~SurvivalTool() = default;
+};
+
+class Rifle final : public Weapon, public SurvivalTool {
+public:
+    void use_as_weapon() override;
+    void use_for_survival() override;
+};
+
+class Compass final : public NavigationTool, public SurvivalTool {
+public:
+    void use_for_navigation() override;
+    void use_for_survival() override;
+};
+
+class Radio final : public CommunicationTool, public SurvivalTool {
+public:
+    void use_for_communication() override;
+    void use_for_survival() override;
+};
+
+inline void Rifle::use_as_weapon() {
+    std::cout << "Using rifle to engage target" << std::endl;
+}
+
+inline void Rifle::use_for_survival() {
+    std::cout << "Using rifle to hunt for food" << std::endl;
+}
+
+inline void Compass::use_for_navigation() {
+    std::cout << "Using compass to determine direction" << std::endl;
+}
+
+inline void Compass::use_for_survival() {
+    std::cout << "Using compass to find way back to safety" << std::endl;
+}
+
+inline void Radio::use_for_communication() {
+    std::cout << "Using radio to call for support" << std::endl;
+}
+
+inline void Radio::use_for_survival() {
+    std::cout << "Using radio to call for rescue" << std::endl;
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Equipment.cpp"
+
+// Inventory of equipment that answers "which items can navigate?" without
+// exceptions or dynamic_cast. When an item is added, its capabilities are
+// read from the interfaces its type implements and recorded as a bitmask.
+// For a final type that happens at compile time; an item added through a
+// base or other non-final type may implement more than that type shows, so
+// its other interfaces are looked up once, with dynamic_cast, on add. The
+// item's index is appended to a dense list per capability, so a sweep such
+// as for_each_navigation_tool() touches only matching items and calls them
+// through an already converted pointer.
+
+enum Capability : std::uint8_t {
+    kWeapon = 1 << 0,
+    kNavigation = 1 << 1,
+    kCommunication = 1 << 2,
+    kSurvival = 1 << 3,
+};
+
+template <typename T>
+constexpr std::uint8_t capabilities_of() {
+    return (std::is_base_of<Weapon, T>::value ? kWeapon : 0) |
+           (std::is_base_of<NavigationTool, T>::value ? kNavigation : 0) |
+           (std::is_base_of<CommunicationTool, T>::value ? kCommunication : 0) |
+           (std::is_base_of<SurvivalTool, T>::value ? kSurvival : 0);
+}
+
+class EquipmentInventory {
+public:
+    // Takes ownership of the item and returns its index
+    template <typename T>
+    std::size_t add(std::unique_ptr<T> item) {
+        static_assert(capabilities_of<T>() != 0, "equipment must implement at least one capability interface");
+
+        Entry entry;
+        T* raw = item.get();
+        entry.weapon = as<Weapon>(raw);
+        entry.navigation = as<NavigationTool>(raw);
+        entry.communication = as<CommunicationTool>(raw);
+        entry.survival = as<SurvivalTool>(raw);
+        const std::uint8_t caps = (entry.weapon ? kWeapon : 0) | (entry.navigation ? kNavigation : 0) |
+                                  (entry.communication ? kCommunication : 0) | (entry.survival ? kSurvival : 0);
+        entry.capabilities = caps;
+        entry.owner = Owner(item.release(), [](void* p) { delete static_cast<T*>(p); });
+
+        std::uint32_t index = static_cast<std::uint32_t>(entries.size());
+        entries.push_back(std::move(entry));
+        if (caps & kWeapon) weapons.push_back(index);
+        if (caps & kNavigation) navigation_tools.push_back(index);
+        if (caps & kCommunication) communication_tools.push_back(index);
+        if (caps & kSurvival) survival_tools.push_back(index);
+        return index;
+    }
+
+    std::size_t size() const { return entries.size(); }
+    std::uint8_t capabilities(std::size_t index) const { return entries[index].capabilities; }
+    bool can(std::size_t index, Capability capability) const { return (entries[index].capabilities & capability) != 0; }
+
+    std::size_t count(Capability capability) const { return list_for(capability).size(); }
+
+    // Items with one capability, in insertion order; a mask of several throws
+    const std::vector<std::uint32_t>& indices(Capability capability) const { return list_for(capability); }
+
+    template <typename Fn>
+    void for_each_weapon(Fn&& fn) const {
+        for (std::uint32_t i : weapons) fn(*entries[i].weapon);
+    }
+
+    template <typename Fn>
+    void for_each_navigation_tool(Fn&& fn) const {
+        for (std::uint32_t i : navigation_tools) fn(*entries[i].navigation);
+    }
+
+    template <typename Fn>
+    void for_each_communication_tool(Fn&& fn) const {
+        for (std::uint32_t i : communication_tools) fn(*entries[i].communication);
+    }
+
+    template <typename Fn>
+    void for_each_survival_tool(Fn&& fn) const {
+        for (std::uint32_t i : survival_tools) fn(*entries[i].survival);
+    }
+
+private:
+    using Owner = std::unique_ptr<void, void (*)(void*)>;
+
+    // One pointer per interface, set only when the item implements it
+    struct Entry {
+        Owner owner{nullptr, [](void*) {}};
+        Weapon* weapon = nullptr;
+        NavigationTool* navigation = nullptr;
+        CommunicationTool* communication = nullptr;
+        SurvivalTool* survival = nullptr;
+        std::uint8_t capabilities = 0;
+    };
+
+    // The item as interface I: statically when T implements it, not at all
+    // when T is final and does not, otherwise by asking the object
+    template <typename I, typename T>
+    static I* as(T* item) {
+        if constexpr (std::is_base_of<I, T>::value)
+            return item;
+        else if constexpr (std::is_final<T>::value)
+            return nullptr;
+        else
+            return dynamic_cast<I*>(item);
+    }
+
+    const std::vector<std::uint32_t>& list_for(Capability capability) const {
+        switch (capability) {
+            case kWeapon: return weapons;
+            case kNavigation: return navigation_tools;
+            case kCommunication: return communication_tools;
+            case kSurvival: return survival_tools;
+        }
+        throw std::invalid_argument("expected exactly one capability");
+    }
+
+    std::vector<Entry> entries;
+    std::vector<std::uint32_t> weapons;
+    std::vector<std::uint32_t> navigation_tools;
+    std::vector<std::uint32_t> communication_tools;
+    std::vector<std::uint32_t> survival_tools;
+};
+
+/*
+int main() {
+    EquipmentInventory inventory;
+    inventory.add(std::make_unique<Rifle>());
+    inventory.add(std::make_unique<Compass>());
+    inventory.add(std::make_unique<Radio>());
+
+    std::cout << "Navigation sweep:" << std::endl;
+    inventory.for_each_navigation_tool([](NavigationTool& tool) { tool.use_for_navigation(); });
+
+    std::cout << "\nSurvival sweep:" << std::endl;
+    inventory.for_each_survival_tool([](SurvivalTool& tool) { tool.use_for_survival(); });
+}
+*/
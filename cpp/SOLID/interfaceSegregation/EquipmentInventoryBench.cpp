@@ -0,0 +1,106 @@
+// Navigation sweep over a large inventory, three ways:
+//   bad_design  - call use_for_navigation() on every item, catch the throws (BadUSMCTdg.cpp)
+//   dynamic_cast - segregated interfaces, cross-cast each item to NavigationTool (betterUSMCTdg.cpp)
+//   inventory   - EquipmentInventory::for_each_navigation_tool()
+// usage: EquipmentInventoryBench [items]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+#include "BadEquipment.cpp"
+#include "EquipmentInventory.cpp"
+
+// Swallows the "Using compass..." lines so the sweeps measure dispatch, not the terminal
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+template <typename Fn>
+double time_s(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t items = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    std::vector<std::unique_ptr<bad_design::Equipment>> bad;
+    std::vector<std::unique_ptr<SurvivalTool>> good;  // every item here is a survival tool
+    EquipmentInventory inventory;
+    for (std::size_t i = 0; i < items; ++i) {
+        switch (i % 3) {
+            case 0:
+                bad.push_back(std::make_unique<bad_design::Rifle>());
+                good.push_back(std::make_unique<Rifle>());
+                inventory.add(std::make_unique<Rifle>());
+                break;
+            case 1:
+                bad.push_back(std::make_unique<bad_design::Compass>());
+                good.push_back(std::make_unique<Compass>());
+                inventory.add(std::make_unique<Compass>());
+                break;
+            default:
+                bad.push_back(std::make_unique<bad_design::Radio>());
+                good.push_back(std::make_unique<Radio>());
+                inventory.add(std::make_unique<Radio>());
+        }
+    }
+
+    NullBuffer null;
+    std::streambuf* saved = std::cout.rdbuf(&null);
+
+    std::size_t bad_used = 0, cast_used = 0, inventory_used = 0;
+    double bad_s = time_s([&] {
+        for (auto& item : bad) {
+            try {
+                item->use_for_navigation();
+                ++bad_used;
+            } catch (const std::runtime_error&) {
+            }
+        }
+    });
+    double cast_s = time_s([&] {
+        for (auto& item : good) {
+            if (auto* tool = dynamic_cast<NavigationTool*>(item.get())) {
+                tool->use_for_navigation();
+                ++cast_used;
+            }
+        }
+    });
+    double inventory_s = time_s([&] {
+        inventory.for_each_navigation_tool([&](NavigationTool& tool) {
+            tool.use_for_navigation();
+            ++inventory_used;
+        });
+    });
+
+    std::cout.rdbuf(saved);
+    auto rate = [items](double s) { return double(items) / s / 1e6; };
+    std::cout << items << " items, " << inventory.count(kNavigation) << " navigation tools\n";
+    std::cout << "bad_design (exceptions): " << rate(bad_s) << " M items/s, " << bad_used << " used\n";
+    std::cout << "dynamic_cast           : " << rate(cast_s) << " M items/s, " << cast_used << " used\n";
+    std::cout << "EquipmentInventory     : " << rate(inventory_s) << " M items/s, " << inventory_used << " used\n";
+
+    // items held through a base pointer keep every capability they have
+    EquipmentInventory held;
+    for (auto& item : good)
+        held.add(std::move(item));
+    bool through_base = held.count(kNavigation) == inventory.count(kNavigation) &&
+                        held.count(kWeapon) == inventory.count(kWeapon) && held.count(kSurvival) == items;
+    bool mask_rejected = false;
+    try {
+        held.indices(Capability(kWeapon | kNavigation));
+    } catch (const std::invalid_argument&) {
+        mask_rejected = true;
+    }
+    std::cout << "added through base ptr : " << (through_base ? "capabilities kept" : "CAPABILITIES LOST")
+              << ", combined mask " << (mask_rejected ? "rejected" : "ACCEPTED") << "\n";
+    return bad_used == cast_used && cast_used == inventory_used && through_base && mask_rejected ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <memory>
+#include <string>
+
+#include "RouteEngine.cpp"
+
+// Abstract base class defining the contract for all navigation strategies
+// This adheres to the Liskov Substitution Principle by providing a common interface
+class NavigationStrategy {
+public:
+    // Virtual destructor to ensure proper cleanup of derived classes
+    virtual ~NavigationStrategy() = default;
+
+    // Pure virtual function that derived classes must implement
+    // This defines the contract that all navigation strategies must follow
+    virtual std::string navigate(const std::string& start, const std::string& end) const = 0;
+
+    // Terrain costs this way of navigating implies
+    virtual CostModel costModel() const = 0;
+
+    // Computes a real route with the strategy's cost model
+    // Every strategy routes through the same engine, so any of them can stand in for another
+    Route findRoute(RouteEngine& engine, std::uint32_t start, std::uint32_t goal) const {
+        return engine.findRoute(start, goal, costModel());
+    }
+};
+
+// Concrete implementation of NavigationStrategy using a lensatic compass
+class LensaticCompassStrategy : public NavigationStrategy {
+public:
+    // Override the navigate function to provide specific implementation
+    std::string navigate(const std::string& start, const std::string& end) const override {
+        return "Navigating from " + start + " to " + end + " using a lensatic compass for precise bearings.";
+    }
+
+    // Holding a bearing cross-country: roads bring no benefit, rough ground slows the pace count
+    CostModel costModel() const override {
+        //        Open  Road  Forest Hill  Swamp Blocked
+        return {{{1.0f, 1.0f, 1.5f,  2.0f, 4.0f, 0.0f}}};
+    }
+};
+
+// Concrete implementation of NavigationStrategy using a map
+class MapStrategy : public NavigationStrategy {
+public:
+    // Another specific implementation of the navigate function
+    std::string navigate(const std::string& start, const std::string& end) const override {
+        return "Navigating from " + start + " to " + end + " using a map for terrain association.";
+    }
+
+    // Terrain association: follow roads and low ground the map shows, stay off the contours
+    CostModel costModel() const override {
+        //        Open  Road  Forest Hill  Swamp Blocked
+        return {{{1.0f, 0.7f, 1.8f,  2.5f, 3.0f, 0.0f}}};
+    }
+};
+
+// Concrete implementation of NavigationStrategy using GPS
+class GPSStrategy : public NavigationStrategy {
+public:
+    // GPS-specific implementation of the navigate function
+    std::string navigate(const std::string& start, const std::string& end) const override {
+        return "Navigating from " + start + " to " + end + " using GPS for real-time positioning.";
+    }
+
+    // Real-time positioning makes roads fastest and keeps the traveler moving through hills
+    CostModel costModel() const override {
+        //        Open  Road  Forest Hill  Swamp Blocked
+        return {{{1.0f, 0.4f, 2.0f,  1.6f, 3.0f, 0.0f}}};
+    }
+};
+
+// Traveler class that uses a NavigationStrategy
+// This class demonstrates the Liskov Substitution Principle in action
+class Traveler {
+private:
+    // Use a unique_ptr to manage the lifecycle of the strategy object
+    std::unique_ptr<NavigationStrategy> strategy;
+
+public:
+    // Constructor that takes any NavigationStrategy
+    // This allows for dependency injection and flexibility in choosing strategies
+    explicit Traveler(std::unique_ptr<NavigationStrategy> strategy)
+        : strategy(std::move(strategy)) {}
+
+    // Method to change the strategy at runtime
+    // This demonstrates the ability to substitute different strategies
+    void setStrategy(std::unique_ptr<NavigationStrategy> newStrategy) {
+        strategy = std::move(newStrategy);
+    }
+
+    // Method that uses the current strategy to navigate
+    // This method works with any NavigationStrategy, demonstrating Liskov Substitution
+    std::string travel(const std::string& start, const std::string& end) const {
+        return strategy->navigate(start, end);
+    }
+
+    // The current strategy, for services that route on the traveler's behalf
+    const NavigationStrategy& getStrategy() const {
+        return *strategy;
+    }
+
+    // Routes between two named waypoints of the engine's map using the current strategy
+    Route travelRoute(RouteEngine& engine, const std::string& start, const std::string& end) const {
+        const RouteGraph& graph = engine.getGraph();
+        return strategy->findRoute(engine, graph.waypoint(start), graph.waypoint(end));
+    }
+};
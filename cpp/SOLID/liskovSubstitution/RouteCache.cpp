@@ -0,0 +1,124 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "RouteEngine.cpp"
+
+// A route query reduced to interned IDs: graph nodes for the endpoints
+// and a small number for the strategy. Building one never allocates.
+struct RouteKey {
+    std::uint32_t start;
+    std::uint32_t goal;
+    std::uint32_t strategy;
+
+    bool operator==(const RouteKey& other) const {
+        return start == other.start && goal == other.goal && strategy == other.strategy;
+    }
+
+    std::uint64_t hash() const {
+        std::uint64_t h = (std::uint64_t(start) << 32 | goal) * 0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 29) ^ (std::uint64_t(strategy) * 0xBF58476D1CE4E5B9ull);
+    }
+};
+
+// Hit and miss totals across all shards
+struct RouteCacheStats {
+    std::uint64_t hits;
+    std::uint64_t misses;
+
+    double hitRate() const { return hits + misses == 0 ? 0.0 : double(hits) / double(hits + misses); }
+};
+
+// Concurrent LRU cache of computed routes.
+// Keys are spread over independent shards, each with its own lock, list
+// and map, so threads looking up different routes rarely contend. Routes
+// are shared as immutable shared_ptrs, so a lookup copies a pointer and
+// never a waypoint vector, and an evicted route stays valid for readers
+// still holding it.
+class ShardedRouteCache {
+public:
+    explicit ShardedRouteCache(std::size_t capacity, std::size_t shardCount = 16)
+        : shards(std::max<std::size_t>(1, shardCount)) {
+        std::size_t perShard = (capacity + shards.size() - 1) / shards.size();
+        for (auto& shard : shards) {
+            shard.capacity = std::max<std::size_t>(1, perShard);
+        }
+    }
+
+    // The cached route, or nullptr; a hit moves the route to the front of its shard
+    std::shared_ptr<const Route> find(const RouteKey& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            shard.misses.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+        shard.order.splice(shard.order.begin(), shard.order, it->second);
+        return it->second->second;
+    }
+
+    // Stores a route, evicting the least recently used one of the shard when full
+    void insert(const RouteKey& key, std::shared_ptr<const Route> route) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            it->second->second = std::move(route);
+            shard.order.splice(shard.order.begin(), shard.order, it->second);
+            return;
+        }
+        if (shard.index.size() >= shard.capacity) {
+            shard.index.erase(shard.order.back().first);
+            shard.order.pop_back();
+        }
+        shard.order.emplace_front(key, std::move(route));
+        shard.index.emplace(key, shard.order.begin());
+    }
+
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.index.size();
+        }
+        return total;
+    }
+
+    RouteCacheStats stats() const {
+        RouteCacheStats total{0, 0};
+        for (auto& shard : shards) {
+            total.hits += shard.hits.load(std::memory_order_relaxed);
+            total.misses += shard.misses.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const RouteKey& key) const { return std::size_t(key.hash()); }
+    };
+
+    using Entry = std::pair<RouteKey, std::shared_ptr<const Route>>;
+
+    // Aligned so the locks of neighbouring shards do not share a cache line
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> order;
+        std::unordered_map<RouteKey, std::list<Entry>::iterator, KeyHash> index;
+        std::size_t capacity = 1;
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+    };
+
+    Shard& shardFor(const RouteKey& key) { return shards[(key.hash() >> 40) % shards.size()]; }
+
+    std::vector<Shard> shards;
+};
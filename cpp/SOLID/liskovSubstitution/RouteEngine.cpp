@@ -0,0 +1,142 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "RouteGraph.cpp"
+
+// Cost of stepping onto each kind of terrain, per unit of distance.
+// Every navigation strategy supplies one; the cheapest terrain scales the
+// A* heuristic so it never overestimates the remaining cost.
+struct CostModel {
+    std::array<float, kTerrainCount> perTerrain;
+
+    float minimum() const {
+        float lowest = std::numeric_limits<float>::infinity();
+        for (std::size_t t = 0; t < kTerrainCount; ++t) {
+            if (static_cast<Terrain>(t) != Terrain::Blocked) {
+                lowest = std::min(lowest, perTerrain[t]);
+            }
+        }
+        return lowest;
+    }
+};
+
+// Result of a route query: the cells walked, start and end included,
+// and the total cost under the strategy's cost model
+struct Route {
+    std::vector<GridPoint> waypoints;
+    double cost = 0;
+    bool found = false;
+};
+
+// A* search over a RouteGraph.
+// The engine owns the per-query scratch arrays and reuses them between
+// queries; a generation stamp marks which entries belong to the current
+// query so nothing is cleared per call. The open set is a binary heap
+// with lazy deletion. One engine per thread; the graph itself is shared.
+class RouteEngine {
+public:
+    explicit RouteEngine(const RouteGraph& graph)
+        : graph(graph), bestCost(graph.nodeCount()), parent(graph.nodeCount()), stamp(graph.nodeCount(), 0) {}
+
+    const RouteGraph& getGraph() const { return graph; }
+
+    // Number of nodes taken off the open set by the last query
+    std::size_t expandedNodes() const { return expanded; }
+
+    Route findRoute(std::uint32_t start, std::uint32_t goal, const CostModel& model) {
+        Route route;
+        expanded = 0;
+        if (++generation == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+        if (graph.terrainAt(start) == Terrain::Blocked || graph.terrainAt(goal) == Terrain::Blocked) {
+            return route;
+        }
+
+        const float scale = model.minimum();
+        const GridPoint target = graph.point(goal);
+        auto heuristic = [&](std::uint32_t n) {
+            GridPoint p = graph.point(n);
+            float dx = std::fabs(float(p.x) - float(target.x));
+            float dy = std::fabs(float(p.y) - float(target.y));
+            return scale * (dx + dy + (1.41421356f - 2.0f) * std::min(dx, dy));
+        };
+
+        open.clear();
+        visit(start, 0.0f, start);
+        push(heuristic(start), 0.0f, start);
+        while (!open.empty()) {
+            OpenEntry top = pop();
+            if (top.cost > bestCost[top.node]) {
+                continue;
+            }
+            ++expanded;
+            if (top.node == goal) {
+                route.found = true;
+                route.cost = top.cost;
+                for (std::uint32_t n = goal; ; n = parent[n]) {
+                    route.waypoints.push_back(graph.point(n));
+                    if (n == start) {
+                        break;
+                    }
+                }
+                std::reverse(route.waypoints.begin(), route.waypoints.end());
+                return route;
+            }
+            for (std::uint32_t e = graph.edgesBegin(top.node); e < graph.edgesEnd(top.node); ++e) {
+                std::uint32_t next = graph.edgeTarget(e);
+                float cost = top.cost +
+                    graph.edgeLength(e) * model.perTerrain[static_cast<std::size_t>(graph.terrainAt(next))];
+                if (stamp[next] != generation || cost < bestCost[next]) {
+                    visit(next, cost, top.node);
+                    push(cost + heuristic(next), cost, next);
+                }
+            }
+        }
+        return route;
+    }
+
+private:
+    struct OpenEntry {
+        float priority;
+        float cost;
+        std::uint32_t node;
+    };
+
+    void visit(std::uint32_t n, float cost, std::uint32_t from) {
+        stamp[n] = generation;
+        bestCost[n] = cost;
+        parent[n] = from;
+    }
+
+    // Min-heap on priority
+    void push(float priority, float cost, std::uint32_t n) {
+        open.push_back({priority, cost, n});
+        std::push_heap(open.begin(), open.end(), [](const OpenEntry& a, const OpenEntry& b) {
+            return a.priority > b.priority;
+        });
+    }
+
+    OpenEntry pop() {
+        std::pop_heap(open.begin(), open.end(), [](const OpenEntry& a, const OpenEntry& b) {
+            return a.priority > b.priority;
+        });
+        OpenEntry top = open.back();
+        open.pop_back();
+        return top;
+    }
+
+    const RouteGraph& graph;
+    std::vector<float> bestCost;
+    std::vector<std::uint32_t> parent;
+    std::vector<std::uint32_t> stamp;
+    std::uint32_t generation = 0;
+    std::vector<OpenEntry> open;
+    std::size_t expanded = 0;
+};
@@ -0,0 +1,57 @@
+// Queries/sec of A* routing on a large generated map, per strategy
+// usage: RouteEngineBench [side] [queries] [map-file]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Navigation.cpp"
+
+int main(int argc, char* argv[]) {
+    std::uint32_t side = argc > 1 ? std::uint32_t(std::atoi(argv[1])) : 1024;
+    std::size_t queries = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    std::string file = argc > 3 ? argv[3] : "/tmp/route_bench.map";
+
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point since) {
+        return std::chrono::duration<double>(Clock::now() - since).count();
+    };
+
+    RouteGraph::generate(side, side, 7).save(file);
+    auto loadStart = Clock::now();
+    RouteGraph graph = RouteGraph::load(file);
+    double loadSeconds = seconds(loadStart);
+    std::cout << side << "x" << side << " map, " << graph.edgeCount() << " edges, loaded in " << loadSeconds
+              << " s\n";
+
+    std::mt19937 rng(11);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+    while (pairs.size() < queries) {
+        std::uint32_t a = rng() % graph.nodeCount(), b = rng() % graph.nodeCount();
+        if (graph.terrainAt(a) != Terrain::Blocked && graph.terrainAt(b) != Terrain::Blocked) {
+            pairs.emplace_back(a, b);
+        }
+    }
+
+    RouteEngine engine(graph);
+    std::unique_ptr<NavigationStrategy> strategies[] = {
+        std::make_unique<LensaticCompassStrategy>(), std::make_unique<MapStrategy>(), std::make_unique<GPSStrategy>()};
+    const char* names[] = {"LensaticCompass", "Map", "GPS"};
+    for (int s = 0; s < 3; ++s) {
+        std::size_t found = 0, expanded = 0, waypoints = 0;
+        auto start = Clock::now();
+        for (auto [from, to] : pairs) {
+            Route route = strategies[s]->findRoute(engine, from, to);
+            found += route.found;
+            waypoints += route.waypoints.size();
+            expanded += engine.expandedNodes();
+        }
+        double elapsed = seconds(start);
+        std::cout << names[s] << ": " << double(queries) / elapsed << " queries/s, " << found << "/" << queries
+                  << " found, " << expanded / queries << " nodes expanded and " << waypoints / queries
+                  << " waypoints per query\n";
+    }
+}
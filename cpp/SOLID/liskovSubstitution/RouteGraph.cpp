@@ -0,0 +1,235 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Terrain of one grid cell, as written in map files
+enum class Terrain : std::uint8_t { Open, Road, Forest, Hill, Swamp, Blocked };
+constexpr std::size_t kTerrainCount = 6;
+
+inline Terrain terrainFromChar(char c) {
+    switch (c) {
+        case '.': return Terrain::Open;
+        case '=': return Terrain::Road;
+        case 'T': return Terrain::Forest;
+        case '^': return Terrain::Hill;
+        case '~': return Terrain::Swamp;
+        case '#': return Terrain::Blocked;
+    }
+    throw std::invalid_argument(std::string("unknown terrain '") + c + "'");
+}
+
+inline char terrainToChar(Terrain terrain) {
+    return ".=T^~#"[static_cast<std::size_t>(terrain)];
+}
+
+// A cell position on the grid
+struct GridPoint {
+    std::uint32_t x;
+    std::uint32_t y;
+
+    bool operator==(const GridPoint& other) const { return x == other.x && y == other.y; }
+};
+
+// Terrain grid stored as a compressed sparse row (CSR) graph.
+// Node n is cell (n % width, n / width). The outgoing edges of n are
+// targets[offsets[n] .. offsets[n + 1]), with their lengths alongside:
+// 1 for orthogonal steps and sqrt(2) for diagonal ones. Blocked cells have
+// no edges, and diagonals may not cut the corner of a blocked cell.
+//
+// Map file format:
+//   # comment
+//   grid <width> <height>
+//   <height rows of width terrain characters: . = T ^ ~ #>
+//   waypoint <name> <x> <y>
+class RouteGraph {
+public:
+    // Builds the graph from rows of terrain characters
+    static RouteGraph fromRows(const std::vector<std::string>& rows) {
+        RouteGraph graph;
+        graph.height = static_cast<std::uint32_t>(rows.size());
+        graph.width = rows.empty() ? 0 : static_cast<std::uint32_t>(rows[0].size());
+        graph.terrain.reserve(std::size_t(graph.width) * graph.height);
+        for (const auto& row : rows) {
+            if (row.size() != graph.width) {
+                throw std::invalid_argument("map rows differ in width");
+            }
+            for (char c : row) {
+                graph.terrain.push_back(terrainFromChar(c));
+            }
+        }
+        graph.buildEdges();
+        return graph;
+    }
+
+    // Loads a map file in the format described above
+    static RouteGraph load(const std::string& filename) {
+        std::ifstream in(filename);
+        if (!in) {
+            throw std::runtime_error("cannot open map " + filename);
+        }
+        std::vector<std::string> rows;
+        std::vector<std::pair<std::string, GridPoint>> waypoints;
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream words(line);
+            std::string keyword;
+            if (!(words >> keyword) || keyword[0] == '#') {
+                continue;
+            }
+            if (keyword == "grid") {
+                std::uint32_t w = 0, h = 0;
+                words >> w >> h;
+                rows.resize(h);
+                for (auto& row : rows) {
+                    std::getline(in, row);
+                    if (row.size() != w) {
+                        throw std::runtime_error("map row has wrong width in " + filename);
+                    }
+                }
+            } else if (keyword == "waypoint") {
+                std::string name;
+                GridPoint at{};
+                words >> name >> at.x >> at.y;
+                waypoints.emplace_back(name, at);
+            } else {
+                throw std::runtime_error("unknown map keyword " + keyword + " in " + filename);
+            }
+        }
+        RouteGraph graph = fromRows(rows);
+        for (const auto& [name, at] : waypoints) {
+            graph.addWaypoint(name, at);
+        }
+        return graph;
+    }
+
+    // Writes the graph back in map file format
+    void save(const std::string& filename) const {
+        std::ofstream out(filename);
+        out << "grid " << width << " " << height << "\n";
+        for (std::uint32_t y = 0; y < height; ++y) {
+            for (std::uint32_t x = 0; x < width; ++x) {
+                out << terrainToChar(terrain[node({x, y})]);
+            }
+            out << "\n";
+        }
+        for (const auto& [name, n] : waypointNodes) {
+            out << "waypoint " << name << " " << point(n).x << " " << point(n).y << "\n";
+        }
+        if (!out) {
+            throw std::runtime_error("cannot write map " + filename);
+        }
+    }
+
+    // Random terrain with roads, woods, hills, swamps and walls, for benchmarks
+    static RouteGraph generate(std::uint32_t width, std::uint32_t height, std::uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::vector<std::string> rows(height, std::string(width, '.'));
+        auto paint = [&](char c, std::uint32_t patches, std::uint32_t radius) {
+            for (std::uint32_t p = 0; p < patches; ++p) {
+                std::int64_t cx = rng() % width, cy = rng() % height;
+                std::int64_t r = 1 + rng() % radius;
+                for (std::int64_t y = std::max<std::int64_t>(0, cy - r); y < std::min<std::int64_t>(height, cy + r); ++y) {
+                    for (std::int64_t x = std::max<std::int64_t>(0, cx - r); x < std::min<std::int64_t>(width, cx + r); ++x) {
+                        if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r) {
+                            rows[y][x] = c;
+                        }
+                    }
+                }
+            }
+        };
+        std::uint32_t area = width * height / 4096 + 1;
+        paint('T', area * 4, 12);
+        paint('^', area * 2, 10);
+        paint('~', area, 8);
+        for (std::uint32_t wall = 0; wall < area * 2; ++wall) {
+            std::uint32_t x = rng() % width, y = rng() % height, length = 8 + rng() % 40;
+            bool horizontal = rng() % 2;
+            for (std::uint32_t i = 0; i < length && x < width && y < height; ++i) {
+                rows[y][x] = '#';
+                horizontal ? ++x : ++y;
+            }
+        }
+        for (std::uint32_t y = rng() % 64; y < height; y += 64) {
+            rows[y].assign(width, '=');
+        }
+        for (std::uint32_t x = rng() % 64; x < width; x += 64) {
+            for (auto& row : rows) {
+                row[x] = '=';
+            }
+        }
+        return fromRows(rows);
+    }
+
+    // Names a cell so travelers can route to it by name
+    void addWaypoint(const std::string& name, GridPoint at) {
+        if (at.x >= width || at.y >= height) {
+            throw std::out_of_range("waypoint " + name + " is off the map");
+        }
+        waypointNodes[name] = node(at);
+    }
+
+    std::uint32_t waypoint(const std::string& name) const {
+        auto it = waypointNodes.find(name);
+        if (it == waypointNodes.end()) {
+            throw std::invalid_argument("unknown waypoint " + name);
+        }
+        return it->second;
+    }
+
+    std::uint32_t node(GridPoint at) const { return at.y * width + at.x; }
+    GridPoint point(std::uint32_t n) const { return {n % width, n / width}; }
+
+    std::uint32_t getWidth() const { return width; }
+    std::uint32_t getHeight() const { return height; }
+    std::uint32_t nodeCount() const { return width * height; }
+    std::size_t edgeCount() const { return targets.size(); }
+    Terrain terrainAt(std::uint32_t n) const { return terrain[n]; }
+
+    // Edge range of node n, for the search loop
+    std::uint32_t edgesBegin(std::uint32_t n) const { return offsets[n]; }
+    std::uint32_t edgesEnd(std::uint32_t n) const { return offsets[n + 1]; }
+    std::uint32_t edgeTarget(std::uint32_t e) const { return targets[e]; }
+    float edgeLength(std::uint32_t e) const { return lengths[e]; }
+
+private:
+    void buildEdges() {
+        static const int dx[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+        static const int dy[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+        auto open = [this](std::int64_t x, std::int64_t y) {
+            return x >= 0 && y >= 0 && x < width && y < height && terrain[y * width + x] != Terrain::Blocked;
+        };
+        offsets.assign(std::size_t(nodeCount()) + 1, 0);
+        targets.clear();
+        lengths.clear();
+        for (std::uint32_t n = 0; n < nodeCount(); ++n) {
+            std::int64_t x = n % width, y = n / width;
+            if (open(x, y)) {
+                for (int d = 0; d < 8; ++d) {
+                    bool diagonal = d >= 4;
+                    if (!open(x + dx[d], y + dy[d]) ||
+                        (diagonal && (!open(x + dx[d], y) || !open(x, y + dy[d])))) {
+                        continue;
+                    }
+                    targets.push_back(static_cast<std::uint32_t>((y + dy[d]) * width + x + dx[d]));
+                    lengths.push_back(diagonal ? 1.41421356f : 1.0f);
+                }
+            }
+            offsets[n + 1] = static_cast<std::uint32_t>(targets.size());
+        }
+    }
+
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::vector<Terrain> terrain;
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> targets;
+    std::vector<float> lengths;
+    std::unordered_map<std::string, std::uint32_t> waypointNodes;
+};
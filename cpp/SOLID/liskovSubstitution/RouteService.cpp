@@ -0,0 +1,196 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Navigation.cpp"
+#include "RouteCache.cpp"
+
+// One route request between two graph nodes
+struct RouteQuery {
+    std::uint32_t start;
+    std::uint32_t goal;
+};
+
+// Answers route queries for any NavigationStrategy on one shared map.
+// Results are kept in a ShardedRouteCache keyed on (start, goal, strategy)
+// IDs, so repeated queries cost a hash lookup instead of an A* search.
+// A route depends only on the strategy's cost model, so the strategy ID
+// stands for the cost model: strategies that cost terrain the same share
+// routes, and any difference in costs gets a separate ID.
+// travelBatch fans a vector of queries out over a fixed pool of worker
+// threads, each with its own RouteEngine; the calling thread works too.
+// An exception thrown while answering a query ends the batch and is
+// rethrown from travelBatch once every worker has stopped.
+class RouteService {
+public:
+    RouteService(const RouteGraph& graph, std::size_t cacheCapacity,
+                 unsigned threads = std::thread::hardware_concurrency())
+        : graph(graph), cache(cacheCapacity) {
+        threads = std::max(threads, 1u);
+        for (unsigned t = 0; t < threads; ++t) {
+            engines.push_back(std::make_unique<RouteEngine>(graph));
+        }
+        for (unsigned t = 1; t < threads; ++t) {
+            workers.emplace_back([this, t] { workerLoop(*engines[t]); });
+        }
+    }
+
+    ~RouteService() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    RouteService(const RouteService&) = delete;
+    RouteService& operator=(const RouteService&) = delete;
+
+    // Resolves waypoint names once, so repeated queries carry only IDs
+    RouteQuery query(const std::string& start, const std::string& end) const {
+        return {graph.waypoint(start), graph.waypoint(end)};
+    }
+
+    // A single query on the calling thread; not to be mixed with a running travelBatch
+    std::shared_ptr<const Route> travel(const NavigationStrategy& strategy, RouteQuery q) {
+        check(q);
+        return solve(*engines[0], strategy, strategyId(strategy), q);
+    }
+
+    // Answers every query, results in query order; one batch at a time
+    std::vector<std::shared_ptr<const Route>> travelBatch(const NavigationStrategy& strategy,
+                                                          const std::vector<RouteQuery>& queries) {
+        for (const RouteQuery& q : queries) {
+            check(q);
+        }
+        std::vector<std::shared_ptr<const Route>> results(queries.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = Job{&strategy, strategyId(strategy), &queries, &results};
+            next.store(0, std::memory_order_relaxed);
+            busy = workers.size();
+            error = nullptr;
+            ++batch;
+        }
+        wake.notify_all();
+        runJobCatching(*engines[0]);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return busy == 0; });
+        if (error) {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+        return results;
+    }
+
+    RouteCacheStats cacheStats() const { return cache.stats(); }
+    std::size_t threadCount() const { return engines.size(); }
+
+private:
+    struct Job {
+        const NavigationStrategy* strategy = nullptr;
+        std::uint32_t strategyId = 0;
+        const std::vector<RouteQuery>* queries = nullptr;
+        std::vector<std::shared_ptr<const Route>>* results = nullptr;
+    };
+
+    // Small number per distinct cost model, so cache keys stay three integers
+    std::uint32_t strategyId(const NavigationStrategy& strategy) {
+        const CostModel model = strategy.costModel();
+        std::lock_guard<std::mutex> lock(idMutex);
+        auto inserted = strategyIds.emplace(model.perTerrain, std::uint32_t(strategyIds.size()));
+        return inserted.first->second;
+    }
+
+    void check(const RouteQuery& q) const {
+        if (q.start >= graph.nodeCount() || q.goal >= graph.nodeCount()) {
+            throw std::out_of_range("route query node out of range: " + std::to_string(q.start) + " -> " +
+                                    std::to_string(q.goal));
+        }
+    }
+
+    std::shared_ptr<const Route> solve(RouteEngine& engine, const NavigationStrategy& strategy, std::uint32_t id,
+                                       RouteQuery q) {
+        RouteKey key{q.start, q.goal, id};
+        if (auto cached = cache.find(key)) {
+            return cached;
+        }
+        auto route = std::make_shared<const Route>(strategy.findRoute(engine, q.start, q.goal));
+        cache.insert(key, route);
+        return route;
+    }
+
+    // Claims queries in small chunks until the batch is exhausted
+    void runJob(RouteEngine& engine) {
+        const std::size_t chunk = 8;
+        const std::size_t count = job.queries->size();
+        for (std::size_t begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk)) {
+            for (std::size_t i = begin; i < std::min(begin + chunk, count); ++i) {
+                (*job.results)[i] = solve(engine, *job.strategy, job.strategyId, (*job.queries)[i]);
+            }
+        }
+    }
+
+    // Keeps the first exception of the batch and makes everyone stop claiming queries
+    void runJobCatching(RouteEngine& engine) {
+        try {
+            runJob(engine);
+        } catch (...) {
+            next.store(job.queries->size(), std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    void workerLoop(RouteEngine& engine) {
+        std::uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || batch != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = batch;
+            }
+            runJobCatching(engine);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    const RouteGraph& graph;
+    ShardedRouteCache cache;
+    std::vector<std::unique_ptr<RouteEngine>> engines;
+    std::vector<std::thread> workers;
+
+    std::mutex idMutex;
+    std::map<std::array<float, kTerrainCount>, std::uint32_t> strategyIds;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    Job job;
+    std::atomic<std::size_t> next{0};
+    std::size_t busy = 0;
+    std::uint64_t batch = 0;
+    std::exception_ptr error;
+    bool stopping = false;
+};
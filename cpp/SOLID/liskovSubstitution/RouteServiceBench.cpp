@@ -0,0 +1,148 @@
+// Route cache and batched queries under a skewed (Zipfian) query mix
+// usage: RouteServiceBench [side] [queries] [distinct-pairs] [threads] [cache-capacity]
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "RouteService.cpp"
+
+// One strategy class whose costs are set per instance
+class TunedStrategy : public NavigationStrategy {
+public:
+    explicit TunedStrategy(float roadCost) : roadCost(roadCost) {}
+
+    std::string navigate(const std::string& start, const std::string& end) const override {
+        return "Navigating from " + start + " to " + end + " with tuned road costs.";
+    }
+
+    CostModel costModel() const override {
+        return {{{1.0f, roadCost, 1.5f, 2.0f, 3.0f, 0.0f}}};
+    }
+
+private:
+    float roadCost;
+};
+
+// Answers the first costModel() call and fails on every later one, i.e. inside the workers
+class FailingStrategy : public GPSStrategy {
+public:
+    CostModel costModel() const override {
+        if (calls.fetch_add(1) > 0) {
+            throw std::runtime_error("cost model unavailable");
+        }
+        return GPSStrategy::costModel();
+    }
+
+private:
+    mutable std::atomic<int> calls{0};
+};
+
+int main(int argc, char* argv[]) {
+    std::uint32_t side = argc > 1 ? std::uint32_t(std::atoi(argv[1])) : 256;
+    std::size_t queryCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000;
+    std::size_t distinct = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 5000;
+    unsigned threads = argc > 4 ? unsigned(std::atoi(argv[4])) : std::thread::hardware_concurrency();
+    std::size_t capacity = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 2000;
+
+    RouteGraph graph = RouteGraph::generate(side, side, 7);
+    std::mt19937 rng(3);
+    std::vector<RouteQuery> pairs;
+    while (pairs.size() < distinct) {
+        std::uint32_t a = rng() % graph.nodeCount(), b = rng() % graph.nodeCount();
+        if (graph.terrainAt(a) != Terrain::Blocked && graph.terrainAt(b) != Terrain::Blocked) {
+            pairs.push_back({a, b});
+        }
+    }
+
+    // Zipf(1.0) over the distinct pairs: the k-th pair is asked with weight 1/k
+    std::vector<double> weights(distinct);
+    for (std::size_t k = 0; k < distinct; ++k) {
+        weights[k] = 1.0 / double(k + 1);
+    }
+    std::discrete_distribution<std::size_t> zipf(weights.begin(), weights.end());
+    std::vector<RouteQuery> queries(queryCount);
+    for (auto& q : queries) {
+        q = pairs[zipf(rng)];
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto rate = [&](Clock::time_point since) {
+        return double(queryCount) / std::chrono::duration<double>(Clock::now() - since).count();
+    };
+    GPSStrategy gps;
+
+    RouteEngine engine(graph);
+    double checksum = 0;
+    auto start = Clock::now();
+    for (auto q : queries) {
+        checksum += gps.findRoute(engine, q.start, q.goal).cost;
+    }
+    std::cout << "uncached            : " << rate(start) << " queries/s\n";
+
+    {
+        RouteService service(graph, capacity, 1);
+        double cachedSum = 0;
+        start = Clock::now();
+        for (auto q : queries) {
+            cachedSum += service.travel(gps, q)->cost;
+        }
+        auto stats = service.cacheStats();
+        std::cout << "cached, one thread  : " << rate(start) << " queries/s, hit rate " << stats.hitRate()
+                  << (cachedSum == checksum ? "" : " (COST MISMATCH)") << "\n";
+    }
+    {
+        RouteService service(graph, capacity, threads);
+        start = Clock::now();
+        auto routes = service.travelBatch(gps, queries);
+        double batchRate = rate(start);
+        double batchSum = 0;
+        for (auto& route : routes) {
+            batchSum += route->cost;
+        }
+        auto stats = service.cacheStats();
+        std::cout << "travelBatch, " << service.threadCount() << " thr : " << batchRate << " queries/s, hit rate "
+                  << stats.hitRate() << " (" << stats.hits << " hits, " << stats.misses << " misses)"
+                  << (batchSum == checksum ? "" : " (COST MISMATCH)") << "\n";
+    }
+
+    // Same strategy class, different costs: the cache must not hand one the other's routes
+    bool ok = true;
+    {
+        RouteService service(graph, capacity, threads);
+        TunedStrategy cheapRoads(0.3f), dearRoads(3.0f);
+        std::vector<RouteQuery> sample(queries.begin(), queries.begin() + std::min<std::size_t>(queries.size(), 200));
+        auto cheap = service.travelBatch(cheapRoads, sample);
+        auto dear = service.travelBatch(dearRoads, sample);
+        std::size_t wrong = 0;
+        for (std::size_t i = 0; i < sample.size(); ++i) {
+            wrong += cheap[i]->cost != cheapRoads.findRoute(engine, sample[i].start, sample[i].goal).cost;
+            wrong += dear[i]->cost != dearRoads.findRoute(engine, sample[i].start, sample[i].goal).cost;
+        }
+        std::cout << "per-instance costs  : " << (wrong ? "WRONG ROUTES SERVED" : "ok") << "\n";
+        ok = ok && wrong == 0;
+
+        auto throws = [&](auto&& call) {
+            try {
+                call();
+            } catch (const std::exception&) {
+                return true;
+            }
+            return false;
+        };
+        FailingStrategy broken;
+        bool rethrown = throws([&] { service.travelBatch(broken, sample); });
+        bool rangeChecked = throws([&] { service.travelBatch(gps, {{0, graph.nodeCount()}}); }) &&
+                            throws([&] { service.travel(gps, {graph.nodeCount() + 5, 0}); });
+        bool usable = service.travelBatch(gps, sample).size() == sample.size();
+        std::cout << "errors              : " << (rethrown ? "rethrown" : "NOT RETHROWN") << ", "
+                  << (rangeChecked ? "bad nodes rejected" : "BAD NODES ACCEPTED") << ", "
+                  << (usable ? "service usable after" : "SERVICE BROKEN") << "\n";
+        ok = ok && rethrown && rangeChecked && usable;
+    }
+    return ok ? 0 : 1;
+}
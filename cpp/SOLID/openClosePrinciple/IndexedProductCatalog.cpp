@@ -0,0 +1,201 @@
+#pragma once
+// product catalog with secondary indexes on color and size
+//
+// ProductFilter scans every product for every query. IndexedProductCatalog
+// keeps posting lists of rows per Color, per Size and per (Color, Size) pair,
+// maintained as products are inserted and removed. IndexedProductFilter plugs
+// into the Filter<Product> interface: it flattens an AndSpecification tree
+// into its color and size leaves, reads the narrowest posting list, and only
+// re-checks the specification when the tree has leaves the indexes cannot
+// answer. A color && size query reads the pair list directly, so its cost is
+// proportional to the number of matches, not to the catalog size. Only the
+// exact And, color and size types are read from the indexes: a subclass may
+// override is_satisfied, so it is re-checked per product like any other leaf.
+//
+// Rows are dense: removing a product moves the last row into its place, and
+// every posting list records where each row sits so both steps are O(1).
+// Results come back in posting-list order, not insertion order.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include "ProductSpecification.cpp"
+
+using namespace std;
+
+constexpr size_t kColorCount = 3;
+constexpr size_t kSizeCount = 3;
+
+class IndexedProductCatalog {
+public:
+    // indexes p by its current color and size; inserting twice is a no-op
+    void insert(Product* p) {
+        if (row_of.count(p)) return;
+        auto row = static_cast<uint32_t>(products.size());
+        auto color = static_cast<uint8_t>(p->color);
+        auto size = static_cast<uint8_t>(p->size);
+        products.push_back(p);
+        rows.push_back({color, size,
+                        add_posting(by_color[color], row),
+                        add_posting(by_size[size], row),
+                        add_posting(by_pair[pair_of(color, size)], row)});
+        row_of.emplace(p, row);
+    }
+
+    // call before changing a product's color or size, and insert it again after
+    bool remove(Product* p) {
+        auto it = row_of.find(p);
+        if (it == row_of.end()) return false;
+        uint32_t row = it->second;
+        row_of.erase(it);
+
+        const Row removed = rows[row];
+        remove_posting(by_color[removed.color], removed.color_pos, &Row::color_pos);
+        remove_posting(by_size[removed.size], removed.size_pos, &Row::size_pos);
+        remove_posting(by_pair[pair_of(removed.color, removed.size)], removed.pair_pos, &Row::pair_pos);
+
+        auto last = static_cast<uint32_t>(products.size() - 1);
+        if (row != last) {
+            const Row moved = rows[last];
+            products[row] = products[last];
+            rows[row] = moved;
+            by_color[moved.color][moved.color_pos] = row;
+            by_size[moved.size][moved.size_pos] = row;
+            by_pair[pair_of(moved.color, moved.size)][moved.pair_pos] = row;
+            row_of[products[row]] = row;
+        }
+        products.pop_back();
+        rows.pop_back();
+        return true;
+    }
+
+    const vector<Product*>& items() const { return products; }
+    size_t size() const { return products.size(); }
+
+    // answers spec from the indexes, scanning only when nothing is indexed
+    vector<Product*> query(const Specification<Product>& spec) const {
+        Plan plan;
+        collect(spec, plan);
+        vector<Product*> result;
+        if (plan.empty) return result;
+
+        const vector<uint32_t>* candidates = nullptr;
+        if (plan.color >= 0 && plan.size >= 0)
+            candidates = &by_pair[pair_of(uint8_t(plan.color), uint8_t(plan.size))];
+        else if (plan.color >= 0)
+            candidates = &by_color[size_t(plan.color)];
+        else if (plan.size >= 0)
+            candidates = &by_size[size_t(plan.size)];
+
+        if (candidates == nullptr) {
+            for (auto* p : products)
+                if (spec.is_satisfied(p)) result.push_back(p);
+            return result;
+        }
+        result.reserve(candidates->size());
+        for (uint32_t row : *candidates)
+            if (!plan.residual || spec.is_satisfied(products[row]))
+                result.push_back(products[row]);
+        return result;
+    }
+
+private:
+    struct Row {
+        uint8_t color;
+        uint8_t size;
+        uint32_t color_pos;
+        uint32_t size_pos;
+        uint32_t pair_pos;
+    };
+
+    // what an AndSpecification tree asks of the indexes
+    struct Plan {
+        int color = -1;
+        int size = -1;
+        bool residual = false;  // some leaf must still be checked per product
+        bool empty = false;     // contradictory leaves, e.g. red && green
+    };
+
+    static size_t pair_of(uint8_t color, uint8_t size) { return color * kSizeCount + size; }
+
+    static uint32_t add_posting(vector<uint32_t>& list, uint32_t row) {
+        list.push_back(row);
+        return static_cast<uint32_t>(list.size() - 1);
+    }
+
+    // swap-removes the entry at pos and fixes the moved row's recorded position
+    void remove_posting(vector<uint32_t>& list, uint32_t pos, uint32_t Row::*field) {
+        uint32_t moved = list.back();
+        list[pos] = moved;
+        rows[moved].*field = pos;
+        list.pop_back();
+    }
+
+    static void collect(const Specification<Product>& spec, Plan& plan) {
+        const type_info& type = typeid(spec);
+        if (type == typeid(AndSpecification<Product>)) {
+            auto& both = static_cast<const AndSpecification<Product>&>(spec);
+            collect(both.first, plan);
+            collect(both.second, plan);
+        } else if (type == typeid(ColorSpecification)) {
+            int color = static_cast<int>(static_cast<const ColorSpecification&>(spec).color);
+            if (plan.color >= 0 && plan.color != color) plan.empty = true;
+            plan.color = color;
+        } else if (type == typeid(SizeSpecification)) {
+            int size = static_cast<int>(static_cast<const SizeSpecification&>(spec).size);
+            if (plan.size >= 0 && plan.size != size) plan.empty = true;
+            plan.size = size;
+        } else {
+            plan.residual = true;
+        }
+    }
+
+    vector<Product*> products;
+    vector<Row> rows;
+    unordered_map<Product*, uint32_t> row_of;
+    array<vector<uint32_t>, kColorCount> by_color;
+    array<vector<uint32_t>, kSizeCount> by_size;
+    array<vector<uint32_t>, kColorCount * kSizeCount> by_pair;
+};
+
+// Filter that uses the catalog's indexes when asked to filter its items,
+// and falls back to a ProductFilter scan for any other vector
+struct IndexedProductFilter : Filter<Product> {
+    const IndexedProductCatalog& catalog;
+
+    IndexedProductFilter(const IndexedProductCatalog& catalog) : catalog(catalog) {}
+
+    vector<Product*> filter(const vector<Product*>& items, const Specification<Product>& spec) override {
+        if (&items == &catalog.items())
+            return catalog.query(spec);
+        return ProductFilter().filter(items, spec);
+    }
+};
+
+/*
+int main()
+{
+    Product apple{"Apple", Color::green, Size::small};
+    Product tree{"Tree", Color::green, Size::large};
+    Product house{"House", Color::blue, Size::large};
+
+    IndexedProductCatalog catalog;
+    catalog.insert(&apple);
+    catalog.insert(&tree);
+    catalog.insert(&house);
+
+    ColorSpecification blue(Color::blue);
+    SizeSpecification large(Size::large);
+    AndSpecification<Product> blue_and_large(blue, large);
+
+    IndexedProductFilter ipf(catalog);
+    for(auto& item : ipf.filter(catalog.items(), blue_and_large))
+        cout << item->name << " is blue and large\n";
+
+    return 0;
+}
+*/
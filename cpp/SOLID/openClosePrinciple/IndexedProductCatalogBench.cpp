@@ -0,0 +1,86 @@
+// selective queries: ProductFilter scan versus IndexedProductFilter
+// usage: IndexedProductCatalogBench [products] [repeats]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "IndexedProductCatalog.cpp"
+
+using namespace std;
+
+// a SizeSpecification subclass the indexes must not take at face value
+struct AtLeastSize : SizeSpecification {
+    AtLeastSize(Size size) : SizeSpecification(size) {}
+
+    bool is_satisfied(Product* item) const override {
+        return item->size >= size;
+    }
+};
+
+template <typename Fn>
+double time_ms(Fn&& fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 20;
+
+    // skewed traits so that "blue and large" is rare: 1% blue, 10% large
+    vector<Product> products;
+    products.reserve(count);
+    srand(42);
+    for (size_t i = 0; i < count; ++i) {
+        int c = rand() % 100, s = rand() % 100;
+        products.push_back({"Item", c == 0 ? Color::blue : (c % 2 ? Color::red : Color::green),
+                            s < 10 ? Size::large : (s % 2 ? Size::small : Size::medium)});
+    }
+
+    IndexedProductCatalog catalog;
+    double insert_ms = time_ms([&] { for (auto& p : products) catalog.insert(&p); });
+
+    ColorSpecification blue(Color::blue);
+    SizeSpecification large(Size::large);
+    ColorSpecification green(Color::green);
+    AndSpecification<Product> blue_and_large(blue, large);
+    AtLeastSize medium_or_larger(Size::medium);
+    AndSpecification<Product> blue_medium_or_larger(blue, medium_or_larger);
+
+    ProductFilter pf;
+    IndexedProductFilter ipf(catalog);
+    struct Query { const char* label; const Specification<Product>* spec; };
+    Query queries[] = {{"blue and large", &blue_and_large}, {"blue", &blue}, {"green", &green},
+                       {"blue, medium or larger", &blue_medium_or_larger}};
+
+    cout << count << " products, indexed in " << insert_ms << " ms\n";
+    bool ok = true;
+    for (auto& q : queries) {
+        size_t scan_hits = 0, index_hits = 0;
+        double scan_ms = time_ms([&] {
+            for (int r = 0; r < repeats; ++r) scan_hits = pf.filter(catalog.items(), *q.spec).size();
+        });
+        double index_ms = time_ms([&] {
+            for (int r = 0; r < repeats; ++r) index_hits = ipf.filter(catalog.items(), *q.spec).size();
+        });
+        cout << q.label << ": " << index_hits << " matches, scan " << scan_ms / repeats
+             << " ms, index " << index_ms / repeats << " ms"
+             << (scan_hits == index_hits ? "" : " (MISMATCH)") << "\n";
+        ok = ok && scan_hits == index_hits;
+    }
+
+    size_t churn = count / 10;
+    double churn_ms = time_ms([&] {
+        for (size_t i = 0; i < churn; ++i) catalog.remove(&products[i * 7 % count]);
+        for (size_t i = 0; i < churn; ++i) catalog.insert(&products[i * 7 % count]);
+    });
+    cout << "remove + insert: " << churn_ms * 1e6 / (2 * churn) << " ns/op\n";
+    size_t after = ipf.filter(catalog.items(), blue_and_large).size();
+    size_t expect = pf.filter(catalog.items(), blue_and_large).size();
+    cout << "after churn: " << after << " / " << expect << " blue and large\n";
+    return ok && after == expect ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+#pragma once
+// columnar product storage and block-at-a-time specifications
+//
+// ProductFilter asks a Specification about one Product* at a time. For large
+// catalogs ColumnTable<Product> stores each trait in its own packed column
+// instead: one byte per Color, one byte per Size, and a 32-bit id into a
+// table of interned names. A BatchSpecification looks at a block of rows at
+// once and writes a selection bitmap (bit i set = row first+i matches),
+// comparing 32 or 16 bytes per instruction where AVX2 or SSE2 is available.
+//
+// The batch specifications extend the existing ones rather than replacing
+// them, so each still works with ProductFilter on a vector<Product*>.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "ProductSpecification.cpp"
+
+using namespace std;
+
+// rows per block; a block's selection is kBlockWords 64-bit words
+constexpr size_t kBlockRows = 4096;
+constexpr size_t kBlockWords = kBlockRows / 64;
+
+template <typename T>
+struct ColumnTable;
+
+template <>
+struct ColumnTable<Product> {
+    vector<uint8_t> colors;
+    vector<uint8_t> sizes;
+    vector<uint32_t> name_ids;
+
+    void reserve(size_t n) {
+        colors.reserve(n);
+        sizes.reserve(n);
+        name_ids.reserve(n);
+    }
+
+    uint32_t add(const Product& p) {
+        colors.push_back(static_cast<uint8_t>(p.color));
+        sizes.push_back(static_cast<uint8_t>(p.size));
+        name_ids.push_back(intern(p.name));
+        return static_cast<uint32_t>(colors.size() - 1);
+    }
+
+    size_t size() const { return colors.size(); }
+
+    const string& name(size_t row) const { return names[name_ids[row]]; }
+
+    Product product(size_t row) const {
+        return Product{name(row), static_cast<Color>(colors[row]), static_cast<Size>(sizes[row])};
+    }
+
+private:
+    uint32_t intern(const string& name) {
+        auto it = name_index.find(name);
+        if (it != name_index.end()) return it->second;
+        names.push_back(name);
+        uint32_t id = static_cast<uint32_t>(names.size() - 1);
+        name_index.emplace(name, id);
+        return id;
+    }
+
+    vector<string> names;
+    unordered_map<string, uint32_t> name_index;
+};
+
+using ProductTable = ColumnTable<Product>;
+
+// sets bit i of bits when column[i] == value, for i < count; bits past count are zero
+inline void select_equal(const uint8_t* column, size_t count, uint8_t value, uint64_t* bits) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    for (; i + 64 <= count; i += 64) {
+        auto lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i)), needle)));
+        auto hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i + 32)), needle)));
+        bits[i / 64] = uint64_t(lo) | uint64_t(hi) << 32;
+    }
+#elif defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (size_t lane = 0; lane < 4; ++lane) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i + lane * 16));
+            auto mask = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+            word |= uint64_t(mask) << (lane * 16);
+        }
+        bits[i / 64] = word;
+    }
+#endif
+    // partial last word, or everything on targets without SSE2
+    for (; i < count; i += 64) {
+        uint64_t word = 0;
+        size_t n = count - i < 64 ? count - i : 64;
+        for (size_t j = 0; j < n; ++j)
+            word |= uint64_t(column[i + j] == value) << j;
+        bits[i / 64] = word;
+    }
+}
+
+// Batch specification interface: a filter criterion over a block of rows
+template <typename T>
+struct BatchSpecification {
+    // first is a multiple of 64 and count <= kBlockRows
+    virtual void select(const ColumnTable<T>& table, size_t first, size_t count, uint64_t* bits) const = 0;
+};
+
+// ColorSpecification that can also evaluate a block of rows
+struct BatchColorSpecification : ColorSpecification, BatchSpecification<Product> {
+    BatchColorSpecification(Color color) : ColorSpecification(color) {}
+
+    void select(const ProductTable& table, size_t first, size_t count, uint64_t* bits) const override {
+        select_equal(table.colors.data() + first, count, static_cast<uint8_t>(color), bits);
+    }
+};
+
+// SizeSpecification that can also evaluate a block of rows
+struct BatchSizeSpecification : SizeSpecification, BatchSpecification<Product> {
+    BatchSizeSpecification(Size size) : SizeSpecification(size) {}
+
+    void select(const ProductTable& table, size_t first, size_t count, uint64_t* bits) const override {
+        select_equal(table.sizes.data() + first, count, static_cast<uint8_t>(size), bits);
+    }
+};
+
+// AndSpecification whose block kernel ANDs the two selection bitmaps
+template <typename First, typename Second>
+struct BatchAndSpecification : AndSpecification<Product>, BatchSpecification<Product> {
+    const First& first_batch;
+    const Second& second_batch;
+
+    BatchAndSpecification(const First& first, const Second& second)
+    : AndSpecification<Product>(first, second), first_batch(first), second_batch(second) {}
+
+    void select(const ProductTable& table, size_t first, size_t count, uint64_t* bits) const override {
+        uint64_t other[kBlockWords];
+        first_batch.select(table, first, count, bits);
+        second_batch.select(table, first, count, other);
+        // plain word loop; the compiler turns it into vector ANDs
+        for (size_t w = 0, words = (count + 63) / 64; w < words; ++w)
+            bits[w] &= other[w];
+    }
+};
+
+// Batch filter interface
+template <typename T>
+struct BatchFilter {
+    virtual vector<uint32_t> filter(const ColumnTable<T>& table, const BatchSpecification<T>& spec) = 0;
+};
+
+// returns the matching row numbers in ascending order
+struct ProductBatchFilter : BatchFilter<Product> {
+    vector<uint32_t> filter(const ProductTable& table, const BatchSpecification<Product>& spec) override {
+        vector<uint32_t> rows;
+        uint64_t bits[kBlockWords];
+        for (size_t first = 0; first < table.size(); first += kBlockRows) {
+            size_t count = table.size() - first < kBlockRows ? table.size() - first : kBlockRows;
+            size_t words = (count + 63) / 64;
+            spec.select(table, first, count, bits);
+
+            // size the result once per block instead of growing it per row
+            size_t matches = 0;
+            for (size_t w = 0; w < words; ++w) matches += __builtin_popcountll(bits[w]);
+            size_t out = rows.size();
+            rows.resize(out + matches);
+            for (size_t w = 0; w < words; ++w)
+                for (uint64_t word = bits[w]; word != 0; word &= word - 1)
+                    rows[out++] = static_cast<uint32_t>(first + w * 64 + __builtin_ctzll(word));
+        }
+        return rows;
+    }
+};
+
+/*
+int main()
+{
+    ProductTable table;
+    table.add({"Apple", Color::green, Size::small});
+    table.add({"Tree", Color::green, Size::large});
+    table.add({"House", Color::blue, Size::large});
+
+    BatchColorSpecification green(Color::green);
+    BatchSizeSpecification large(Size::large);
+    BatchAndSpecification<BatchColorSpecification, BatchSizeSpecification> green_and_large(green, large);
+
+    ProductBatchFilter bf;
+    for(auto row : bf.filter(table, green_and_large))
+        cout << table.name(row) << " is green and large\n";
+
+    return 0;
+}
+*/
@@ -0,0 +1,61 @@
+// ProductFilter over vector<Product*> versus ProductBatchFilter over a ProductTable
+// usage: ProductTableBench [products] [repeats]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "ProductTable.cpp"
+
+using namespace std;
+
+template <typename Fn>
+double time_ms(Fn&& fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 5000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 5;
+
+    const char* names[] = {"Apple", "Tree", "House", "Car", "Boat", "Shirt", "Lamp"};
+    vector<Product> products;
+    products.reserve(count);
+    srand(42);
+    for (size_t i = 0; i < count; ++i)
+        products.push_back({names[rand() % 7], Color(rand() % 3), Size(rand() % 3)});
+
+    vector<Product*> all;
+    all.reserve(count);
+    ProductTable table;
+    table.reserve(count);
+    for (auto& p : products) {
+        all.push_back(&p);
+        table.add(p);
+    }
+
+    BatchColorSpecification green(Color::green);
+    BatchSizeSpecification large(Size::large);
+    BatchAndSpecification<BatchColorSpecification, BatchSizeSpecification> green_and_large(green, large);
+
+    ProductFilter pf;
+    ProductBatchFilter bf;
+    size_t scalar_hits = 0, batch_hits = 0;
+    double scalar_ms = time_ms([&] {
+        for (int r = 0; r < repeats; ++r) scalar_hits = pf.filter(all, green_and_large).size();
+    });
+    double batch_ms = time_ms([&] {
+        for (int r = 0; r < repeats; ++r) batch_hits = bf.filter(table, green_and_large).size();
+    });
+
+    cout << count << " products, green and large: " << scalar_hits << " / " << batch_hits << " matches\n";
+    cout << "ProductFilter      : " << scalar_ms / repeats << " ms/query, "
+         << scalar_ms * 1e6 / repeats / count << " ns/row\n";
+    cout << "ProductBatchFilter : " << batch_ms / repeats << " ms/query, "
+         << batch_ms * 1e6 / repeats / count << " ns/row\n";
+    return scalar_hits == batch_hits ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#pragma once
+// compile-time combinators for specifications
+//
+// AndSpecification<T> holds two references and reaches both through virtual
+// calls, so color && size && name costs several indirect calls per item.
+// Here spec(...) wraps a concrete specification by value and the operators
+// &&, || and ! build a nested expression type such as
+//     AndExpr<AndExpr<SpecLeaf<ColorSpecification>, SpecLeaf<SizeSpecification>>, ...>
+// Leaves call is_satisfied with a qualified name, so the whole predicate is
+// known at compile time and inlines into one function.
+//
+// ExpressionSpecification adapts any expression back to Specification<T>,
+// so it still plugs into ProductFilter: one virtual call per item instead of
+// one per node. filter_with skips even that call.
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ProductSpecification.cpp"
+
+using namespace std;
+
+// Filter by name prefix specification
+struct NamePrefixSpecification : Specification<Product> {
+    string prefix;
+
+    NamePrefixSpecification(string prefix) : prefix(std::move(prefix)) {}
+
+    bool is_satisfied(Product* item) const override {
+        return item->name.compare(0, prefix.size(), prefix) == 0;
+    }
+};
+
+// base tag for expression nodes; the operators only accept these
+struct SpecExpression {};
+
+template <typename E>
+constexpr bool is_spec_expression_v = is_base_of_v<SpecExpression, decay_t<E>>;
+
+// leaf: a concrete specification held by value, called without the vtable
+template <typename S>
+struct SpecLeaf : SpecExpression {
+    S spec;
+
+    explicit SpecLeaf(S spec) : spec(std::move(spec)) {}
+
+    template <typename T>
+    bool is_satisfied(T* item) const { return spec.S::is_satisfied(item); }
+};
+
+template <typename L, typename R>
+struct AndExpr : SpecExpression {
+    L left;
+    R right;
+
+    AndExpr(L left, R right) : left(std::move(left)), right(std::move(right)) {}
+
+    template <typename T>
+    bool is_satisfied(T* item) const { return left.is_satisfied(item) && right.is_satisfied(item); }
+};
+
+template <typename L, typename R>
+struct OrExpr : SpecExpression {
+    L left;
+    R right;
+
+    OrExpr(L left, R right) : left(std::move(left)), right(std::move(right)) {}
+
+    template <typename T>
+    bool is_satisfied(T* item) const { return left.is_satisfied(item) || right.is_satisfied(item); }
+};
+
+template <typename E>
+struct NotExpr : SpecExpression {
+    E inner;
+
+    explicit NotExpr(E inner) : inner(std::move(inner)) {}
+
+    template <typename T>
+    bool is_satisfied(T* item) const { return !inner.is_satisfied(item); }
+};
+
+// wraps a concrete specification as an expression leaf
+template <typename S>
+SpecLeaf<decay_t<S>> spec(S&& s) {
+    static_assert(!is_abstract_v<decay_t<S>>, "spec() needs a concrete specification type");
+    return SpecLeaf<decay_t<S>>(std::forward<S>(s));
+}
+
+template <typename L, typename R, typename = enable_if_t<is_spec_expression_v<L> && is_spec_expression_v<R>>>
+AndExpr<decay_t<L>, decay_t<R>> operator&&(L&& left, R&& right) {
+    return {std::forward<L>(left), std::forward<R>(right)};
+}
+
+template <typename L, typename R, typename = enable_if_t<is_spec_expression_v<L> && is_spec_expression_v<R>>>
+OrExpr<decay_t<L>, decay_t<R>> operator||(L&& left, R&& right) {
+    return {std::forward<L>(left), std::forward<R>(right)};
+}
+
+template <typename E, typename = enable_if_t<is_spec_expression_v<E>>>
+NotExpr<decay_t<E>> operator!(E&& inner) {
+    return NotExpr<decay_t<E>>(std::forward<E>(inner));
+}
+
+// adapts an expression to the Specification<T> interface used by Filter<T>
+template <typename T, typename E>
+struct ExpressionSpecification : Specification<T> {
+    E expr;
+
+    explicit ExpressionSpecification(E expr) : expr(std::move(expr)) {}
+
+    bool is_satisfied(T* item) const override { return expr.is_satisfied(item); }
+};
+
+template <typename T, typename E>
+ExpressionSpecification<T, decay_t<E>> as_specification(E&& expr) {
+    return ExpressionSpecification<T, decay_t<E>>(std::forward<E>(expr));
+}
+
+// filters with the expression inlined into the loop
+template <typename T, typename E, typename = enable_if_t<is_spec_expression_v<E>>>
+vector<T*> filter_with(const vector<T*>& items, const E& expr) {
+    vector<T*> result;
+    for (auto& item : items)
+        if (expr.is_satisfied(item))
+            result.push_back(item);
+    return result;
+}
+
+/*
+int main()
+{
+    Product apple{"Apple", Color::green, Size::small};
+    Product tree{"Tree", Color::green, Size::large};
+    Product house{"House", Color::blue, Size::large};
+    vector<Product*> all{ &apple, &tree, &house };
+
+    auto green_large_t = spec(ColorSpecification(Color::green))
+                      && spec(SizeSpecification(Size::large))
+                      && spec(NamePrefixSpecification("T"));
+
+    // through the existing Filter interface
+    ProductFilter pf;
+    for(auto& item : pf.filter(all, as_specification<Product>(green_large_t)))
+        cout << item->name << " is green, large and starts with T\n";
+
+    // fully inlined
+    for(auto& item : filter_with(all, !spec(ColorSpecification(Color::green))))
+        cout << item->name << " is not green\n";
+
+    return 0;
+}
+*/
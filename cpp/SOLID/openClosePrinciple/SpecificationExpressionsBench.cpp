@@ -0,0 +1,62 @@
+// compound filter cost: nested AndSpecification versus expression templates
+// usage: SpecificationExpressionsBench [products] [repeats]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "SpecificationExpressions.cpp"
+
+using namespace std;
+
+template <typename Fn>
+double time_ms(Fn&& fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 5000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 5;
+
+    const char* names[] = {"Apple", "Tree", "House", "Car", "Boat", "Shirt", "Lamp", "Tractor"};
+    vector<Product> products;
+    products.reserve(count);
+    srand(42);
+    for (size_t i = 0; i < count; ++i)
+        products.push_back({names[rand() % 8], Color(rand() % 3), Size(rand() % 3)});
+    vector<Product*> all;
+    all.reserve(count);
+    for (auto& p : products) all.push_back(&p);
+
+    ColorSpecification green(Color::green);
+    SizeSpecification large(Size::large);
+    NamePrefixSpecification tr("Tr");
+    AndSpecification<Product> green_and_large(green, large);
+    AndSpecification<Product> chain(green_and_large, tr);
+
+    auto expr = spec(green) && spec(large) && spec(tr);
+    auto adapted = as_specification<Product>(expr);
+
+    ProductFilter pf;
+    size_t chain_hits = 0, adapted_hits = 0, inlined_hits = 0;
+    double chain_ms = time_ms([&] {
+        for (int r = 0; r < repeats; ++r) chain_hits = pf.filter(all, chain).size();
+    });
+    double adapted_ms = time_ms([&] {
+        for (int r = 0; r < repeats; ++r) adapted_hits = pf.filter(all, adapted).size();
+    });
+    double inlined_ms = time_ms([&] {
+        for (int r = 0; r < repeats; ++r) inlined_hits = filter_with(all, expr).size();
+    });
+
+    cout << count << " products, green && large && \"Tr\"*: "
+         << chain_hits << " / " << adapted_hits << " / " << inlined_hits << " matches\n";
+    cout << "AndSpecification chain       : " << chain_ms * 1e6 / repeats / count << " ns/item\n";
+    cout << "expression via ProductFilter : " << adapted_ms * 1e6 / repeats / count << " ns/item\n";
+    cout << "expression via filter_with   : " << inlined_ms * 1e6 / repeats / count << " ns/item\n";
+    return chain_hits == adapted_hits && adapted_hits == inlined_hits ? 0 : 1;
+}
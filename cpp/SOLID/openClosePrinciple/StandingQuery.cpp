@@ -0,0 +1,240 @@
+#pragma once
+// standing queries: filter results kept up to date as the catalog changes
+//
+// Re-running ProductFilter after every small change costs a full scan.
+// ObservableCatalog instead tells its observers about each insert, update
+// and remove. A StandingQuery registers one Specification<Product>, checks
+// only the product that changed, and keeps both its current matches and a
+// feed of the changes to them. Each notification costs O(1) plus one
+// is_satisfied call. An observer follows one catalog at a time and leaves
+// it when either side is destroyed, or on unsubscribe(); on_detach() then
+// tells it to drop whatever it kept about that catalog. Callbacks may
+// unsubscribe observers, their own included, or subscribe new ones.
+
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ProductSpecification.cpp"
+
+using namespace std;
+
+class ObservableCatalog;
+
+// Observer interface for catalog changes
+struct CatalogObserver {
+    CatalogObserver() = default;
+    CatalogObserver(const CatalogObserver&) = delete;
+    CatalogObserver& operator=(const CatalogObserver&) = delete;
+
+    virtual void on_insert(Product* item) = 0;
+    virtual void on_update(Product* item) = 0;
+    virtual void on_remove(Product* item) = 0;
+    // no longer following the catalog: forget its products
+    virtual void on_detach() {}
+    virtual ~CatalogObserver();
+
+private:
+    friend class ObservableCatalog;
+    ObservableCatalog* source = nullptr;
+};
+
+// catalog that notifies observers; update() follows an in-place change to item
+class ObservableCatalog {
+public:
+    ObservableCatalog() = default;
+    ObservableCatalog(const ObservableCatalog&) = delete;
+    ObservableCatalog& operator=(const ObservableCatalog&) = delete;
+
+    ~ObservableCatalog() {
+        for (auto* o : observers) {
+            if (!o) continue;
+            o->source = nullptr;
+            o->on_detach();
+        }
+    }
+
+    // moves observer over from any catalog it followed before
+    void subscribe(CatalogObserver& observer) {
+        if (observer.source == this) return;
+        if (observer.source) observer.source->unsubscribe(observer);
+        observers.push_back(&observer);
+        observer.source = this;
+        for (auto* item : products) observer.on_insert(item);
+    }
+
+    void unsubscribe(CatalogObserver& observer) {
+        if (observer.source != this) return;
+        drop(observer);
+        observer.on_detach();
+    }
+
+    void insert(Product* item) {
+        if (row_of.count(item)) return;
+        row_of.emplace(item, products.size());
+        products.push_back(item);
+        notify([&](CatalogObserver* o) { o->on_insert(item); });
+    }
+
+    void update(Product* item) {
+        if (!row_of.count(item)) return;
+        notify([&](CatalogObserver* o) { o->on_update(item); });
+    }
+
+    void remove(Product* item) {
+        auto it = row_of.find(item);
+        if (it == row_of.end()) return;
+        size_t row = it->second;
+        row_of.erase(it);
+        if (row != products.size() - 1) {
+            products[row] = products.back();
+            row_of[products[row]] = row;
+        }
+        products.pop_back();
+        notify([&](CatalogObserver* o) { o->on_remove(item); });
+    }
+
+    const vector<Product*>& items() const { return products; }
+
+private:
+    friend struct CatalogObserver;
+
+    // Observers that leave during a pass leave a null slot behind, swept
+    // once the outermost pass ends; ones that join during a pass already
+    // saw the change in their replay, so the pass stops at the old count.
+    template <typename Fn>
+    void notify(Fn&& fn) {
+        struct Pass {
+            ObservableCatalog& catalog;
+            ~Pass() {
+                if (--catalog.passes == 0 && catalog.has_gaps) {
+                    auto& list = catalog.observers;
+                    list.erase(std::remove(list.begin(), list.end(), nullptr), list.end());
+                    catalog.has_gaps = false;
+                }
+            }
+        };
+        ++passes;
+        Pass pass{*this};
+        size_t count = observers.size();
+        for (size_t i = 0; i < count; ++i)
+            if (auto* o = observers[i]) fn(o);
+    }
+
+    void drop(CatalogObserver& observer) {
+        auto it = find(observers.begin(), observers.end(), &observer);
+        if (passes > 0) {
+            *it = nullptr;
+            has_gaps = true;
+        } else {
+            observers.erase(it);
+        }
+        observer.source = nullptr;
+    }
+
+    vector<Product*> products;
+    unordered_map<Product*, size_t> row_of;
+    vector<CatalogObserver*> observers;
+    size_t passes = 0;
+    bool has_gaps = false;
+};
+
+// no on_detach() here: the derived part is already gone
+inline CatalogObserver::~CatalogObserver() {
+    if (source) source->drop(*this);
+}
+
+enum class ChangeKind : uint8_t { added, removed };
+
+struct MatchChange {
+    ChangeKind kind;
+    Product* item;
+};
+
+// materialized result of one specification; matches() is in no particular order
+class StandingQuery : public CatalogObserver {
+public:
+    StandingQuery(const Specification<Product>& spec) : spec(spec) {}
+
+    void on_insert(Product* item) override {
+        if (spec.is_satisfied(item)) add(item);
+    }
+
+    void on_update(Product* item) override {
+        bool now = spec.is_satisfied(item);
+        bool was = position.count(item) != 0;
+        if (now && !was) add(item);
+        else if (!now && was) drop(item);
+    }
+
+    void on_remove(Product* item) override {
+        if (position.count(item)) drop(item);
+    }
+
+    // the matches and pending changes belong to the catalog just left
+    void on_detach() override {
+        current.clear();
+        position.clear();
+        feed.clear();
+    }
+
+    const vector<Product*>& matches() const { return current; }
+    size_t size() const { return current.size(); }
+
+    // changes since the last call, oldest first
+    vector<MatchChange> take_changes() { return std::exchange(feed, {}); }
+
+private:
+    void add(Product* item) {
+        position.emplace(item, current.size());
+        current.push_back(item);
+        feed.push_back({ChangeKind::added, item});
+    }
+
+    void drop(Product* item) {
+        auto it = position.find(item);
+        size_t pos = it->second;
+        position.erase(it);
+        if (pos != current.size() - 1) {
+            current[pos] = current.back();
+            position[current[pos]] = pos;
+        }
+        current.pop_back();
+        feed.push_back({ChangeKind::removed, item});
+    }
+
+    const Specification<Product>& spec;
+    vector<Product*> current;
+    unordered_map<Product*, size_t> position;
+    vector<MatchChange> feed;
+};
+
+/*
+int main()
+{
+    Product apple{"Apple", Color::green, Size::small};
+    Product tree{"Tree", Color::green, Size::large};
+
+    ColorSpecification green(Color::green);
+    SizeSpecification large(Size::large);
+    AndSpecification<Product> green_and_large(green, large);
+
+    ObservableCatalog catalog;
+    StandingQuery query(green_and_large);
+    catalog.subscribe(query);
+
+    catalog.insert(&apple);
+    catalog.insert(&tree);
+    apple.size = Size::large;
+    catalog.update(&apple);
+
+    for(auto& change : query.take_changes())
+        cout << change.item->name << (change.kind == ChangeKind::added ? " joined\n" : " left\n");
+    cout << query.size() << " green and large things\n";
+
+    return 0;
+}
+*/
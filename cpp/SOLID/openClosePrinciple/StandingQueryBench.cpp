@@ -0,0 +1,104 @@
+// steady-state cost per tick: re-running ProductFilter versus a StandingQuery
+// usage: StandingQueryBench [products] [updates per tick] [ticks]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "StandingQuery.cpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t updates = argc > 2 ? strtoul(argv[2], nullptr, 10) : 100;
+    int ticks = argc > 3 ? atoi(argv[3]) : 50;
+
+    vector<Product> products;
+    products.reserve(count);
+    srand(42);
+    for (size_t i = 0; i < count; ++i)
+        products.push_back({"Item", Color(rand() % 3), Size(rand() % 3)});
+
+    ColorSpecification green(Color::green);
+    SizeSpecification large(Size::large);
+    AndSpecification<Product> green_and_large(green, large);
+
+    ObservableCatalog catalog;
+    StandingQuery query(green_and_large);
+    catalog.subscribe(query);
+    for (auto& p : products) catalog.insert(&p);
+    query.take_changes();  // the initial load is not part of the steady state
+
+    ProductFilter pf;
+    double rescan_ms = 0, view_ms = 0;
+    size_t rescan_hits = 0, changes = 0;
+    for (int t = 0; t < ticks; ++t) {
+        auto start = chrono::steady_clock::now();
+        for (size_t u = 0; u < updates; ++u) {
+            Product& p = products[size_t(rand()) % count];
+            p.color = Color(rand() % 3);
+            p.size = Size(rand() % 3);
+            catalog.update(&p);
+        }
+        changes += query.take_changes().size();
+        auto mid = chrono::steady_clock::now();
+        rescan_hits = pf.filter(catalog.items(), green_and_large).size();
+        auto end = chrono::steady_clock::now();
+        view_ms += chrono::duration<double, milli>(mid - start).count();
+        rescan_ms += chrono::duration<double, milli>(end - mid).count();
+    }
+
+    cout << count << " products, " << updates << " updates/tick, " << ticks << " ticks\n";
+    cout << "ProductFilter re-scan : " << rescan_ms / ticks << " ms/tick\n";
+    cout << "StandingQuery         : " << view_ms / ticks << " ms/tick ("
+         << changes << " match changes)\n";
+    cout << "matches: " << query.size() << " / " << rescan_hits << "\n";
+
+    // a query that goes away first must leave the catalog, which keeps working
+    {
+        StandingQuery brief(green);
+        catalog.subscribe(brief);
+    }
+    catalog.update(&products[0]);
+    catalog.remove(&products[0]);
+
+    // a query moved to another catalog holds only that catalog's matches
+    StandingQuery moving(green);
+    catalog.subscribe(moving);
+    bool moved_ok;
+    {
+        ObservableCatalog other;
+        Product leaf{"Leaf", Color::green, Size::small}, sky{"Sky", Color::blue, Size::large};
+        other.insert(&leaf);
+        other.insert(&sky);
+        other.subscribe(moving);
+        moved_ok = moving.size() == 1 && moving.matches()[0] == &leaf;
+    }
+    moved_ok = moved_ok && moving.size() == 0;  // the catalog went away first
+
+    // an observer may leave from inside its own callback
+    struct LeaveOnUpdate : StandingQuery {
+        using StandingQuery::StandingQuery;
+        ObservableCatalog* from = nullptr;
+        size_t calls = 0;
+        void on_update(Product* item) override {
+            ++calls;
+            StandingQuery::on_update(item);
+            if (from) from->unsubscribe(*this);
+        }
+    };
+    LeaveOnUpdate leaving(large), staying(green);
+    leaving.from = &catalog;
+    catalog.subscribe(leaving);
+    catalog.subscribe(staying);
+    catalog.update(&products[1]);
+    catalog.update(&products[2]);
+    bool leave_ok = leaving.calls == 1 && leaving.size() == 0 && staying.calls == 2;
+    cout << "observer lifetime: " << (moved_ok ? "moved query ok" : "MOVED QUERY STALE") << ", "
+         << (leave_ok ? "unsubscribe in callback ok" : "UNSUBSCRIBE IN CALLBACK BROKEN") << "\n";
+
+    return query.size() == rescan_hits && moved_ok && leave_ok ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+#pragma once
+// streaming and parallel filters over Specification<T>
+//
+// Filter<T>::filter always builds the complete vector<T*> before returning.
+// StreamingFilter<T> hands matches out as they are found instead: to a
+// callback that can stop the scan, as a lazy range for range-for, or to the
+// count / any / first terminals, which stop as soon as the answer is known.
+// The lazy range refers to the items and the specification it was given,
+// so both must outlive it; matches() refuses temporaries for either.
+//
+// ParallelFilter<T> splits the input into one contiguous slice per thread.
+// Each thread collects its own matches; the slices are joined in input order,
+// so the result is identical to ProductFilter's. Specifications must be safe
+// to call from several threads at once (the ones in this folder only read).
+// If a specification throws, every thread is still joined and the first
+// exception, in slice order, is rethrown to the caller.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "ProductSpecification.cpp"
+
+using namespace std;
+
+// lazy view of the items that satisfy spec; holds references to both
+template <typename T>
+class FilterRange {
+public:
+    using base_iterator = typename vector<T*>::const_iterator;
+
+    class iterator {
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = T*;
+        using difference_type = ptrdiff_t;
+        using pointer = T* const*;
+        using reference = T* const&;
+
+        iterator(base_iterator it, base_iterator end, const Specification<T>* spec)
+        : it(it), end(end), spec(spec) { skip(); }
+
+        reference operator*() const { return *it; }
+        iterator& operator++() { ++it; skip(); return *this; }
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        bool operator!=(const iterator& other) const { return it != other.it; }
+
+    private:
+        void skip() { while (it != end && !spec->is_satisfied(*it)) ++it; }
+
+        base_iterator it;
+        base_iterator end;
+        const Specification<T>* spec;
+    };
+
+    FilterRange(const vector<T*>& items, const Specification<T>& spec) : items(items), spec(spec) {}
+
+    iterator begin() const { return iterator(items.begin(), items.end(), &spec); }
+    iterator end() const { return iterator(items.end(), items.end(), &spec); }
+
+private:
+    const vector<T*>& items;
+    const Specification<T>& spec;
+};
+
+template <typename T>
+struct StreamingFilter : Filter<T> {
+    // calls sink(item) for each match in order; a sink returning bool stops
+    // the scan by returning false. returns the number of items delivered
+    template <typename Sink>
+    size_t for_each(const vector<T*>& items, const Specification<T>& spec, Sink&& sink) const {
+        size_t delivered = 0;
+        for (auto& item : items) {
+            if (!spec.is_satisfied(item)) continue;
+            ++delivered;
+            if constexpr (is_same_v<decltype(sink(item)), bool>) {
+                if (!sink(item)) break;
+            } else {
+                sink(item);
+            }
+        }
+        return delivered;
+    }
+
+    FilterRange<T> matches(const vector<T*>& items, const Specification<T>& spec) const {
+        return FilterRange<T>(items, spec);
+    }
+
+    // the range would outlive a temporary, e.g. matches(all, ColorSpecification(...))
+    FilterRange<T> matches(const vector<T*>&& items, const Specification<T>& spec) const = delete;
+    FilterRange<T> matches(const vector<T*>& items, const Specification<T>&& spec) const = delete;
+    FilterRange<T> matches(const vector<T*>&& items, const Specification<T>&& spec) const = delete;
+
+    vector<T*> filter(const vector<T*>& items, const Specification<T>& spec) override {
+        vector<T*> result;
+        for_each(items, spec, [&](T* item) { result.push_back(item); });
+        return result;
+    }
+
+    // the first n matches; stops scanning once it has them
+    vector<T*> first(const vector<T*>& items, const Specification<T>& spec, size_t n) const {
+        vector<T*> result;
+        if (n == 0) return result;
+        result.reserve(n);
+        for_each(items, spec, [&](T* item) {
+            result.push_back(item);
+            return result.size() < n;
+        });
+        return result;
+    }
+
+    size_t count(const vector<T*>& items, const Specification<T>& spec) const {
+        size_t n = 0;
+        for (auto& item : items) n += spec.is_satisfied(item);
+        return n;
+    }
+
+    bool any(const vector<T*>& items, const Specification<T>& spec) const {
+        for (auto& item : items)
+            if (spec.is_satisfied(item)) return true;
+        return false;
+    }
+};
+
+template <typename T>
+struct ParallelFilter : Filter<T> {
+    unsigned threads;
+
+    ParallelFilter(unsigned threads = thread::hardware_concurrency()) : threads(max(threads, 1u)) {}
+
+    vector<T*> filter(const vector<T*>& items, const Specification<T>& spec) override {
+        vector<vector<T*>> parts(slices(items));
+        run(items, [&](size_t slice, size_t begin, size_t end) {
+            auto& part = parts[slice];
+            for (size_t i = begin; i < end; ++i)
+                if (spec.is_satisfied(items[i])) part.push_back(items[i]);
+        });
+
+        size_t total = 0;
+        for (auto& part : parts) total += part.size();
+        vector<T*> result;
+        result.reserve(total);
+        for (auto& part : parts) result.insert(result.end(), part.begin(), part.end());
+        return result;
+    }
+
+    size_t count(const vector<T*>& items, const Specification<T>& spec) const {
+        vector<size_t> counts(slices(items));
+        run(items, [&](size_t slice, size_t begin, size_t end) {
+            size_t n = 0;
+            for (size_t i = begin; i < end; ++i) n += spec.is_satisfied(items[i]);
+            counts[slice] = n;
+        });
+        size_t total = 0;
+        for (size_t n : counts) total += n;
+        return total;
+    }
+
+    // every thread stops once any thread has found a match
+    bool any(const vector<T*>& items, const Specification<T>& spec) const {
+        atomic<bool> found{false};
+        run(items, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end && !found.load(memory_order_relaxed); ++i)
+                if (spec.is_satisfied(items[i])) found.store(true, memory_order_relaxed);
+        });
+        return found.load();
+    }
+
+private:
+    size_t slices(const vector<T*>& items) const {
+        return max<size_t>(1, min<size_t>(threads, items.size()));
+    }
+
+    // work(slice, begin, end) on each contiguous slice; slice 0 runs on the
+    // caller. The first exception from any slice is rethrown on the caller
+    template <typename Work>
+    void run(const vector<T*>& items, Work&& work) const {
+        size_t n = slices(items);
+        size_t per = (items.size() + n - 1) / n;
+        vector<exception_ptr> errors(n);
+        auto slice = [&](size_t s) {
+            try { work(s, min(s * per, items.size()), min((s + 1) * per, items.size())); }
+            catch (...) { errors[s] = current_exception(); }
+        };
+        {
+            // joins whatever was started, also when starting a thread fails
+            struct JoinAll {
+                vector<thread>& workers;
+                ~JoinAll() { for (auto& w : workers) w.join(); }
+            };
+            vector<thread> workers;
+            workers.reserve(n - 1);
+            JoinAll join{workers};
+            for (size_t s = 1; s < n; ++s)
+                workers.emplace_back(slice, s);
+            slice(0);
+        }
+        for (auto& e : errors)
+            if (e) rethrow_exception(e);
+    }
+};
+
+/*
+int main()
+{
+    Product apple{"Apple", Color::green, Size::small};
+    Product tree{"Tree", Color::green, Size::large};
+    Product house{"House", Color::blue, Size::large};
+    vector<Product*> all{ &apple, &tree, &house };
+
+    ColorSpecification green(Color::green);
+    StreamingFilter<Product> sf;
+    for(auto* item : sf.matches(all, green))
+        cout << item->name << " is green\n";
+    cout << sf.count(all, green) << " green things\n";
+
+    ParallelFilter<Product> pf(4);
+    cout << pf.filter(all, green).size() << " green things\n";
+
+    return 0;
+}
+*/
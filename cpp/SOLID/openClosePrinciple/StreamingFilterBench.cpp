@@ -0,0 +1,95 @@
+// full materialization versus streaming terminals and the parallel filter
+// usage: StreamingFilterBench [products] [threads]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "StreamingFilter.cpp"
+
+using namespace std;
+
+template <typename Fn>
+double time_ms(Fn&& fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// matches() must not compile with a temporary specification
+template <typename Spec, typename = void>
+struct matches_accepts : false_type {};
+template <typename Spec>
+struct matches_accepts<Spec, void_t<decltype(declval<const StreamingFilter<Product>&>().matches(
+                                 declval<const vector<Product*>&>(), declval<Spec>()))>> : true_type {};
+static_assert(matches_accepts<const ColorSpecification&>::value, "lvalue specification");
+static_assert(!matches_accepts<ColorSpecification>::value, "temporary specification");
+
+// throws on one product, to check that ParallelFilter reports errors
+struct FailingSpecification : Specification<Product> {
+    Product* bad;
+    FailingSpecification(Product* bad) : bad(bad) {}
+    bool is_satisfied(Product* item) const override {
+        if (item == bad) throw runtime_error("cannot judge this product");
+        return true;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 5000000;
+    unsigned threads = argc > 2 ? unsigned(atoi(argv[2])) : thread::hardware_concurrency();
+
+    vector<Product> products;
+    products.reserve(count);
+    srand(42);
+    for (size_t i = 0; i < count; ++i)
+        products.push_back({"Item", Color(rand() % 3), Size(rand() % 3)});
+    vector<Product*> all;
+    all.reserve(count);
+    for (auto& p : products) all.push_back(&p);
+
+    ColorSpecification green(Color::green);
+    SizeSpecification large(Size::large);
+    AndSpecification<Product> green_and_large(green, large);
+
+    ProductFilter pf;
+    StreamingFilter<Product> sf;
+    ParallelFilter<Product> par(threads);
+
+    size_t full = 0, counted = 0, firsts = 0, par_full = 0, par_counted = 0;
+    bool found = false;
+    double full_ms = time_ms([&] { full = pf.filter(all, green_and_large).size(); });
+    double count_ms = time_ms([&] { counted = sf.count(all, green_and_large); });
+    double first_ms = time_ms([&] { firsts = sf.first(all, green_and_large, 10).size(); });
+    double any_ms = time_ms([&] { found = sf.any(all, green_and_large); });
+    double par_ms = time_ms([&] { par_full = par.filter(all, green_and_large).size(); });
+    double par_count_ms = time_ms([&] { par_counted = par.count(all, green_and_large); });
+    bool same_order = par.filter(all, green_and_large) == pf.filter(all, green_and_large);
+
+    cout << count << " products, " << threads << " threads\n";
+    cout << "ProductFilter::filter   : " << full_ms << " ms (" << full << ")\n";
+    cout << "StreamingFilter::count  : " << count_ms << " ms (" << counted << ")\n";
+    cout << "StreamingFilter::first  : " << first_ms << " ms (" << firsts << ")\n";
+    cout << "StreamingFilter::any    : " << any_ms << " ms (" << found << ")\n";
+    cout << "ParallelFilter::filter  : " << par_ms << " ms (" << par_full << ")\n";
+    cout << "ParallelFilter::count   : " << par_count_ms << " ms (" << par_counted << ")\n";
+    cout << "parallel order matches  : " << (same_order ? "yes" : "NO") << "\n";
+
+    // a throwing specification on a worker slice, then on the caller's slice
+    size_t rethrown = 0;
+    for (Product* bad : {all.back(), all.front()}) {
+        FailingSpecification failing(bad);
+        try {
+            par.filter(all, failing);
+        } catch (const runtime_error&) {
+            ++rethrown;
+        }
+    }
+    cout << "parallel errors         : " << (rethrown == 2 ? "rethrown" : "LOST") << "\n";
+    return same_order && full == counted && full == par_counted && rethrown == 2 ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+#pragma once
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Journal.cpp"
+
+using namespace std;
+
+// Append-only persistence with group commit.
+// PersistenceManager::save rewrites the whole journal on every call. The
+// writer below keeps the file open in append mode: append() only copies the
+// line into the pending batch, and a background thread writes each batch
+// with a single write() call once the GroupCommitPolicy says it is due.
+// Like PersistenceManager it is a separate concern from Journal; attach()
+// follows a journal through Journal::subscribe until detach() or the
+// writer's destruction.
+
+// when a batch of pending lines is written out
+struct GroupCommitPolicy{
+    size_t max_entries = 1024;                  // commit once this many lines are pending
+    size_t max_bytes = 1 << 20;                 // ... or this many bytes
+    chrono::microseconds max_delay{1000};       // ... or the oldest line has waited this long
+    bool fsync = false;                         // fdatasync after each batch
+};
+
+class AsyncJournalWriter{
+public:
+    AsyncJournalWriter(const string& filename, GroupCommitPolicy policy = {})
+        : policy(policy)
+    {
+        fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if(fd < 0)
+            throw runtime_error("cannot open journal file " + filename);
+        writer = thread([this]{ run(); });
+    }
+
+    ~AsyncJournalWriter()
+    {
+        detach();
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        ready.notify_one();
+        writer.join();
+        ::close(fd);
+    }
+
+    AsyncJournalWriter(const AsyncJournalWriter&) = delete;
+    AsyncJournalWriter& operator=(const AsyncJournalWriter&) = delete;
+
+    // every entry added to j from now on is appended to the file; replaces
+    // any journal attached before
+    void attach(Journal& j)
+    {
+        subscription = j.subscribe([this](const string& line){ append(line); });
+    }
+
+    void detach() { subscription.reset(); }
+
+    // queues one line and returns its sequence number (1-based)
+    uint64_t append(const string& line)
+    {
+        lock_guard<mutex> lock(m);
+        if(pending_entries == 0)
+            oldest = chrono::steady_clock::now();
+        pending.append(line);
+        pending.push_back('\n');
+        ++pending_entries;
+        uint64_t seq = ++appended;
+        // the first line starts the writer's max_delay timer
+        if(pending_entries == 1 || pending_entries >= policy.max_entries || pending.size() >= policy.max_bytes)
+            ready.notify_one();
+        return seq;
+    }
+
+    // blocks until line seq has been written (and synced, if the policy asks
+    // for it); the wait still lets other lines join the same batch
+    void wait_committed(uint64_t seq)
+    {
+        unique_lock<mutex> lock(m);
+        committed_cv.wait(lock, [&]{ return committed >= seq || failed; });
+        if(failed)
+            throw runtime_error("journal write failed");
+    }
+
+    // blocks until every line appended so far has been committed
+    void flush()
+    {
+        uint64_t target;
+        {
+            lock_guard<mutex> lock(m);
+            target = appended;
+            flush_requested = true;
+        }
+        ready.notify_one();
+        wait_committed(target);
+    }
+
+    uint64_t committed_count() const
+    {
+        lock_guard<mutex> lock(m);
+        return committed;
+    }
+
+private:
+    bool due() const
+    {
+        return pending_entries >= policy.max_entries
+            || pending.size() >= policy.max_bytes
+            || chrono::steady_clock::now() - oldest >= policy.max_delay;
+    }
+
+    void run()
+    {
+        string batch;
+        unique_lock<mutex> lock(m);
+        for(;;){
+            if(pending_entries == 0){
+                if(stopping)
+                    return;
+                ready.wait(lock, [&]{ return stopping || pending_entries > 0; });
+                continue;
+            }
+            if(!stopping && !flush_requested && !due()){
+                ready.wait_until(lock, oldest + policy.max_delay);
+                continue;
+            }
+
+            batch.swap(pending);
+            pending.clear();
+            uint64_t batch_end = appended;
+            pending_entries = 0;
+            flush_requested = false;
+            lock.unlock();
+
+            bool ok = write_all(batch) && (!policy.fsync || sync());
+
+            lock.lock();
+            if(ok)
+                committed = batch_end;
+            else
+                failed = true;
+            committed_cv.notify_all();
+        }
+    }
+
+    bool write_all(const string& data)
+    {
+        const char* p = data.data();
+        size_t left = data.size();
+        while(left > 0){
+            ssize_t n = ::write(fd, p, left);
+            if(n < 0){
+                if(errno == EINTR)      // interrupted before writing anything: try again
+                    continue;
+                return false;
+            }
+            p += n;
+            left -= size_t(n);
+        }
+        return true;
+    }
+
+    bool sync()
+    {
+        int r;
+        while((r = ::fdatasync(fd)) != 0 && errno == EINTR){}
+        return r == 0;
+    }
+
+    GroupCommitPolicy policy;
+    int fd = -1;
+    Journal::Subscription subscription;
+
+    mutable mutex m;
+    condition_variable ready;
+    condition_variable committed_cv;
+    string pending;
+    size_t pending_entries = 0;
+    chrono::steady_clock::time_point oldest;
+    uint64_t appended = 0;
+    uint64_t committed = 0;
+    bool flush_requested = false;
+    bool stopping = false;
+    bool failed = false;
+
+    thread writer;
+};
+
+/*
+int main(){
+    Journal journal{"Dear Diary"};
+    AsyncJournalWriter writer("diary.log");
+    writer.attach(journal);
+
+    journal.add_entry("I see a bug");
+    journal.add_entry("I walked 5 miles today");
+    writer.flush();
+}
+*/
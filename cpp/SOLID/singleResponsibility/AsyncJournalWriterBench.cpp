@@ -0,0 +1,113 @@
+// durability versus throughput: PersistenceManager::save per entry against
+// AsyncJournalWriter under several group-commit policies
+// usage: AsyncJournalWriterBench [entries] [directory]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AsyncJournalWriter.cpp"
+
+using namespace std;
+using bench_clock = chrono::steady_clock;
+
+static double percentile(vector<double> v, double p)
+{
+    if(v.empty())
+        return 0;
+    sort(v.begin(), v.end());
+    return v[min(v.size() - 1, size_t(p * double(v.size())))];
+}
+
+static void report(const string& label, size_t entries, double total_s, const vector<double>& latencies_us)
+{
+    cout << label << ": " << size_t(double(entries) / total_s) << " entries/s, append p50 "
+         << percentile(latencies_us, 0.50) << " us, p99 " << percentile(latencies_us, 0.99) << " us\n";
+}
+
+int main(int argc, char* argv[]){
+    size_t entries = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    string dir = argc > 2 ? argv[2] : "/tmp";
+    string text = "Patrol reached checkpoint and reported no contact";
+
+    // the current path: rewrite the whole file after every entry (quadratic,
+    // so it gets a smaller run)
+    {
+        size_t n = min<size_t>(entries, 2000);
+        Journal journal{"baseline"};
+        vector<double> lat;
+        auto start = bench_clock::now();
+        for(size_t i = 0; i < n; ++i){
+            auto t0 = bench_clock::now();
+            journal.add_entry(text);
+            PersistenceManager::save(journal, dir + "/journal_bench_save.txt");
+            lat.push_back(chrono::duration<double, micro>(bench_clock::now() - t0).count());
+        }
+        double total = chrono::duration<double>(bench_clock::now() - start).count();
+        report("save per entry (" + to_string(n) + ")", n, total, lat);
+    }
+
+    // fire-and-forget appends through Journal::add_entry; durability comes
+    // with the final flush
+    struct Case{ const char* label; GroupCommitPolicy policy; };
+    GroupCommitPolicy buffered;
+    GroupCommitPolicy synced;
+    synced.fsync = true;
+    Case async_cases[] = {
+        {"async, no fsync              ", buffered},
+        {"async, fsync per batch       ", synced},
+    };
+    for(auto& c : async_cases){
+        string path = dir + "/journal_bench_append.log";
+        remove(path.c_str());
+        Journal journal{"bench"};
+        vector<double> lat;
+        lat.reserve(entries);
+        auto start = bench_clock::now();
+        {
+            AsyncJournalWriter writer(path, c.policy);
+            writer.attach(journal);
+            for(size_t i = 0; i < entries; ++i){
+                auto t0 = bench_clock::now();
+                journal.add_entry(text);
+                lat.push_back(chrono::duration<double, micro>(bench_clock::now() - t0).count());
+            }
+            writer.flush();
+        }
+        double total = chrono::duration<double>(bench_clock::now() - start).count();
+        report(string(c.label) + "(" + to_string(entries) + ")", entries, total, lat);
+    }
+
+    // durable appends: each producer waits for its line to be synced, so
+    // concurrent producers share one fdatasync per batch
+    for(size_t producers : {size_t(1), size_t(8)}){
+        size_t n = min<size_t>(entries, 4000);
+        string path = dir + "/journal_bench_append.log";
+        remove(path.c_str());
+        vector<vector<double>> lat(producers);
+        auto start = bench_clock::now();
+        {
+            AsyncJournalWriter writer(path, synced);
+            vector<thread> threads;
+            for(size_t p = 0; p < producers; ++p)
+                threads.emplace_back([&, p]{
+                    for(size_t i = p; i < n; i += producers){
+                        auto t0 = bench_clock::now();
+                        writer.wait_committed(writer.append(text));
+                        lat[p].push_back(chrono::duration<double, micro>(bench_clock::now() - t0).count());
+                    }
+                });
+            for(auto& t : threads)
+                t.join();
+        }
+        double total = chrono::duration<double>(bench_clock::now() - start).count();
+        vector<double> all;
+        for(auto& l : lat)
+            all.insert(all.end(), l.begin(), l.end());
+        report("durable, fsync, " + to_string(producers) + " producer(s) (" + to_string(n) + ")", n, total, all);
+    }
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Journal.cpp"
+
+using namespace std;
+
+// Journal for many threads logging at once.
+// Every add_entry takes its number from one atomic counter; that number is
+// also the entry's slot, so entries are stored in number order no matter
+// which thread finishes first. Slots live in fixed-size chunks that are
+// created on demand with a compare-and-swap, and the "N: entry" text is
+// formatted straight into a per-thread arena block, so appending needs no
+// lock and, outside of the occasional new block or chunk, no allocation.
+// The number is taken with a compare-and-swap only after the text space and
+// the chunk exist, so an add_entry that throws takes no number.
+//
+// A slot is readable once its text pointer is published; entry(n) waits for
+// that, so read entries after the writers that own them have returned.
+
+class ConcurrentJournal{
+public:
+    static constexpr size_t chunk_slots = 4096;
+    static constexpr size_t max_chunks = 1 << 16;       // 268M entries
+    static constexpr size_t arena_block_size = 1 << 20;
+    static constexpr size_t max_digits = 20;            // of a uint64_t entry number
+
+    explicit ConcurrentJournal(string title)
+        : title(std::move(title)), chunks(new atomic<Chunk*>[max_chunks]), id(next_id())
+    {
+        for(size_t i = 0; i < max_chunks; ++i)
+            chunks[i].store(nullptr, memory_order_relaxed);
+    }
+
+    ~ConcurrentJournal()
+    {
+        for(size_t i = 0; i < max_chunks; ++i)
+            delete chunks[i].load(memory_order_relaxed);
+        for(Block* b = blocks.load(); b != nullptr;){
+            Block* next = b->next;
+            ::operator delete(b);
+            b = next;
+        }
+    }
+
+    ConcurrentJournal(const ConcurrentJournal&) = delete;
+    ConcurrentJournal& operator=(const ConcurrentJournal&) = delete;
+
+    const string title;
+
+    // safe from any number of threads; returns the entry's number (1-based)
+    uint64_t add_entry(string_view entry)
+    {
+        // Everything that can throw happens before a number is taken: a
+        // number nobody publishes would leave readers waiting forever.
+        const size_t max_length = max_digits + 2 + entry.size();
+        char* text = allocate(max_length);
+        uint64_t taken = next_number.load(memory_order_relaxed);
+        Chunk* chunk;
+        try{
+            do{
+                if(taken / chunk_slots >= max_chunks)
+                    throw length_error("concurrent journal is full");
+                chunk = &chunk_for(size_t(taken));
+            }while(!next_number.compare_exchange_weak(taken, taken + 1, memory_order_relaxed));
+        }catch(...){
+            give_back(max_length);
+            throw;
+        }
+        uint64_t number = taken + 1;
+
+        char* digits_end = to_chars(text, text + max_digits, number).ptr;
+        size_t digit_count = size_t(digits_end - text);
+        size_t length = digit_count + 2 + entry.size();
+        memcpy(text + digit_count, ": ", 2);
+        memcpy(text + digit_count + 2, entry.data(), entry.size());
+        give_back(max_length - length);
+
+        Slot& s = chunk->slots[size_t(taken) % chunk_slots];
+        s.length = uint32_t(length);
+        s.text.store(text, memory_order_release);
+        return number;
+    }
+
+    // entries numbered so far; some may still be being written
+    size_t size() const { return size_t(next_number.load(memory_order_acquire)); }
+
+    // entry number n+1 as "N: entry"
+    string_view entry(size_t n) const
+    {
+        if(n >= size())
+            throw out_of_range("journal entry out of range");
+        Chunk* c;
+        while((c = chunks[n / chunk_slots].load(memory_order_acquire)) == nullptr)
+            this_thread::yield();
+        const Slot& s = c->slots[n % chunk_slots];
+        const char* text;
+        while((text = s.text.load(memory_order_acquire)) == nullptr)
+            this_thread::yield();
+        return {text, s.length};
+    }
+
+    // copies into a plain Journal, e.g. for PersistenceManager::save
+    Journal snapshot() const
+    {
+        Journal j{title};
+        size_t n = size();
+        j.entries.reserve(n);
+        for(size_t i = 0; i < n; ++i)
+            j.entries.emplace_back(entry(i));
+        j.next_number = uint64_t(n) + 1;
+        return j;
+    }
+
+private:
+    struct Slot{
+        atomic<const char*> text{nullptr};
+        uint32_t length = 0;
+    };
+
+    struct Chunk{
+        Slot slots[chunk_slots];
+    };
+
+    struct Block{
+        Block* next;
+        size_t capacity;
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    struct Cursor{
+        uint64_t journal;
+        char* pos;
+        char* end;
+    };
+
+    static uint64_t next_id()
+    {
+        static atomic<uint64_t> id{1};
+        return id.fetch_add(1);
+    }
+
+    Chunk& chunk_for(size_t slot)
+    {
+        atomic<Chunk*>& entry = chunks[slot / chunk_slots];
+        Chunk* c = entry.load(memory_order_acquire);
+        if(c == nullptr){
+            Chunk* fresh = new Chunk;
+            if(entry.compare_exchange_strong(c, fresh, memory_order_acq_rel))
+                c = fresh;
+            else
+                delete fresh;   // another thread installed it first; c holds theirs
+        }
+        return *c;
+    }
+
+    // this thread's allocation cursor for this journal
+    Cursor& cursor()
+    {
+        thread_local vector<Cursor> cursors;
+        for(auto& c : cursors)
+            if(c.journal == id)
+                return c;
+        cursors.push_back({id, nullptr, nullptr});
+        return cursors.back();
+    }
+
+    // returns the last length bytes this thread allocated
+    void give_back(size_t length) { cursor().pos -= length; }
+
+    // bump allocation from this thread's current block for this journal
+    char* allocate(size_t length)
+    {
+        Cursor* cur = &cursor();
+        if(size_t(cur->end - cur->pos) < length){
+            Block* b = new_block(length > arena_block_size ? length : arena_block_size);
+            cur->pos = b->data();
+            cur->end = b->data() + b->capacity;
+        }
+        char* p = cur->pos;
+        cur->pos += length;
+        return p;
+    }
+
+    Block* new_block(size_t capacity)
+    {
+        auto* b = static_cast<Block*>(::operator new(sizeof(Block) + capacity));
+        b->capacity = capacity;
+        b->next = blocks.load(memory_order_relaxed);
+        while(!blocks.compare_exchange_weak(b->next, b, memory_order_release, memory_order_relaxed)){}
+        return b;
+    }
+
+    unique_ptr<atomic<Chunk*>[]> chunks;
+    atomic<uint64_t> next_number{0};
+    atomic<Block*> blocks{nullptr};
+    uint64_t id;
+};
+
+/*
+int main(){
+    ConcurrentJournal journal{"Dear Diary"};
+    vector<thread> writers;
+    for(int t = 0; t < 4; ++t)
+        writers.emplace_back([&]{ journal.add_entry("I see a bug"); });
+    for(auto& w : writers)
+        w.join();
+
+    PersistenceManager::save(journal.snapshot(), "diary.txt");
+}
+*/
@@ -0,0 +1,55 @@
+// appends from 1..N threads: Journal behind a mutex versus ConcurrentJournal
+// usage: ConcurrentJournalBench [entries per thread] [max threads]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentJournal.cpp"
+
+using namespace std;
+using bench_clock = chrono::steady_clock;
+
+template <typename Append>
+double run(size_t threads, size_t per_thread, Append&& append)
+{
+    auto start = bench_clock::now();
+    vector<thread> workers;
+    for(size_t t = 0; t < threads; ++t)
+        workers.emplace_back([&]{
+            for(size_t i = 0; i < per_thread; ++i)
+                append();
+        });
+    for(auto& w : workers)
+        w.join();
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]){
+    size_t per_thread = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    size_t max_threads = argc > 2 ? strtoul(argv[2], nullptr, 10) : max(8u, thread::hardware_concurrency());
+    const string text = "Patrol reached checkpoint and reported no contact";
+
+    for(size_t threads = 1; threads <= max_threads; threads *= 2){
+        size_t total = threads * per_thread;
+
+        Journal locked{"locked"};
+        mutex m;
+        double locked_s = run(threads, per_thread, [&]{
+            lock_guard<mutex> lock(m);
+            locked.add_entry(text);
+        });
+
+        ConcurrentJournal concurrent{"concurrent"};
+        double concurrent_s = run(threads, per_thread, [&]{ concurrent.add_entry(text); });
+
+        bool ok = concurrent.size() == total && concurrent.entry(total - 1).substr(0, to_string(total).size()) == to_string(total);
+        cout << threads << " threads: Journal+mutex " << double(total) / locked_s / 1e6
+             << " M entries/s, ConcurrentJournal " << double(total) / concurrent_s / 1e6 << " M entries/s"
+             << (ok ? "" : " (CHECK FAILED)") << "\n";
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <charconv>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//Journal takes care of concerns related to journal operations.
+struct Journal{
+    string title;
+    vector<string> entries;
+    uint64_t next_number = 1;    // number add_entry gives the next entry
+
+    // called with each new entry line; lets other concerns follow the journal
+    using EntryListener = function<void(const string& line)>;
+
+    // keeps a listener subscribed; reset() or destruction unsubscribes it,
+    // even if the journal has been moved or destroyed in the meantime.
+    // Like add_entry, not to be used while another thread adds entries.
+    class Subscription{
+    public:
+        Subscription() = default;
+        explicit Subscription(const shared_ptr<EntryListener>& listener) : listener(listener) {}
+        Subscription(Subscription&&) = default;
+        Subscription& operator=(Subscription&& other)
+        {
+            reset();
+            listener = std::move(other.listener);
+            return *this;
+        }
+        ~Subscription() { reset(); }
+
+        void reset()
+        {
+            if(auto l = listener.lock())
+                *l = nullptr;
+            listener.reset();
+        }
+
+    private:
+        weak_ptr<EntryListener> listener;
+    };
+
+    // Constructure to set the title
+    Journal(const string &title) : title(title) {}
+
+    void add_entry(const string& entry);
+
+    [[nodiscard]] Subscription subscribe(EntryListener listener)
+    {
+        listeners.push_back(make_shared<EntryListener>(std::move(listener)));
+        return Subscription{listeners.back()};
+    }
+
+private:
+    vector<shared_ptr<EntryListener>> listeners;
+};
+
+inline void Journal::add_entry(const string& entry) {
+    // "N: entry" built in place: one allocation per line
+    char digits[20];
+    auto end = to_chars(digits, digits + sizeof digits, next_number++).ptr;
+    string line;
+    line.reserve(size_t(end - digits) + 2 + entry.size());
+    line.append(digits, end).append(": ").append(entry);
+    entries.push_back(std::move(line));
+    bool unsubscribed = false;
+    for(auto& listener : listeners){
+        if(*listener)
+            (*listener)(entries.back());
+        else
+            unsubscribed = true;
+    }
+    if(unsubscribed)
+        listeners.erase(remove_if(listeners.begin(), listeners.end(), [](auto& l){ return !*l; }), listeners.end());
+}
+
+// persistence is another concern out side of the Journal
+struct PersistenceManager{
+    // where Journal is loaded and saved
+    static void save(const Journal& j, const string& filename)
+
+    {
+        ofstream ofs(filename);
+        for(auto& s : j.entries)
+            ofs << s << '\n';
+    }
+};
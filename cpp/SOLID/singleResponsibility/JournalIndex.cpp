@@ -0,0 +1,371 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Journal.cpp"
+
+using namespace std;
+
+// Full-text search is its own concern: JournalIndex follows a Journal through
+// Journal::subscribe and keeps an inverted index from each word to the
+// entries containing it.
+//
+// Words are lower-cased runs of letters and digits from the text after the
+// "N: " prefix. Entries only ever get appended, so each word's posting list
+// is an increasing run of entry positions, stored as varint-encoded gaps and
+// extended in place. Queries: term, all_of (AND), any_of (OR) and prefix,
+// each returning entry positions (0-based, as in Journal::entries) in order.
+//
+// save()/load() keep the index in a file next to the journal; after load(),
+// catch_up() indexes whatever the journal gained since it was saved. load()
+// trusts nothing in the file: lengths are checked against the bytes left
+// and every posting is decoded once before it is accepted. An index that
+// has seen more entries than the journal it is given belongs to another
+// journal and is rejected.
+// attach() follows the journal until detach(), destruction or a move of
+// the index; a moved index has to be attached again.
+
+class JournalIndex{
+public:
+    JournalIndex() = default;
+
+    // the subscription points at the old object, so moving detaches
+    JournalIndex(JournalIndex&& other) noexcept
+        : postings(std::move(other.postings)), doc_count(other.doc_count)
+    {
+        other.detach();
+    }
+
+    JournalIndex& operator=(JournalIndex&& other) noexcept
+    {
+        detach();
+        other.detach();
+        postings = std::move(other.postings);
+        doc_count = other.doc_count;
+        return *this;
+    }
+
+    void attach(Journal& j)
+    {
+        catch_up(j);
+        subscription = j.subscribe([this](const string& line){ add(line); });
+    }
+
+    void detach() { subscription.reset(); }
+
+    // indexes entries of j that this index has not seen yet
+    void catch_up(const Journal& j)
+    {
+        if(doc_count > j.entries.size())
+            throw runtime_error("journal index covers " + to_string(doc_count) + " entries, journal has "
+                                + to_string(j.entries.size()));
+        for(size_t i = doc_count; i < j.entries.size(); ++i)
+            add(j.entries[i]);
+    }
+
+    size_t size() const { return doc_count; }
+    size_t term_count() const { return postings.size(); }
+
+    vector<uint32_t> term(string_view word) const
+    {
+        auto it = postings.find(normalize(word));
+        return it == postings.end() ? vector<uint32_t>{} : decode(it->second);
+    }
+
+    vector<uint32_t> all_of(const vector<string>& words) const
+    {
+        vector<const Posting*> lists;
+        for(auto& w : words){
+            auto it = postings.find(normalize(w));
+            if(it == postings.end())
+                return {};
+            lists.push_back(&it->second);
+        }
+        if(lists.empty())
+            return {};
+        // start from the rarest word so every intersection is as small as possible
+        sort(lists.begin(), lists.end(), [](auto* a, auto* b){ return a->count < b->count; });
+        vector<uint32_t> result = decode(*lists[0]);
+        for(size_t i = 1; i < lists.size() && !result.empty(); ++i)
+            result = intersect(result, *lists[i]);
+        return result;
+    }
+
+    vector<uint32_t> any_of(const vector<string>& words) const
+    {
+        vector<const Posting*> lists;
+        for(auto& w : words){
+            auto it = postings.find(normalize(w));
+            if(it != postings.end())
+                lists.push_back(&it->second);
+        }
+        return union_of(lists);
+    }
+
+    vector<uint32_t> prefix(string_view start) const
+    {
+        string p = normalize(start);
+        vector<const Posting*> lists;
+        for(auto it = postings.lower_bound(p); it != postings.end() && it->first.compare(0, p.size(), p) == 0; ++it)
+            lists.push_back(&it->second);
+        return union_of(lists);
+    }
+
+    void save(const string& filename) const
+    {
+        ofstream ofs(filename, ios::binary | ios::trunc);
+        write_u32(ofs, kMagic);
+        write_u32(ofs, kVersion);
+        write_u32(ofs, uint32_t(doc_count));
+        write_u32(ofs, uint32_t(postings.size()));
+        for(auto& [word, p] : postings){
+            write_u32(ofs, uint32_t(word.size()));
+            ofs.write(word.data(), streamsize(word.size()));
+            write_u32(ofs, p.count);
+            write_u32(ofs, p.last);
+            write_u32(ofs, uint32_t(p.bytes.size()));
+            ofs.write(reinterpret_cast<const char*>(p.bytes.data()), streamsize(p.bytes.size()));
+        }
+        if(!ofs)
+            throw runtime_error("failed writing index " + filename);
+    }
+
+    static JournalIndex load(const string& filename)
+    {
+        ifstream ifs(filename, ios::binary | ios::ate);
+        uint64_t left = ifs ? uint64_t(ifs.tellg()) : 0;
+        ifs.seekg(0);
+        // a length read from the file may not claim more than the file has left
+        auto take = [&](uint64_t bytes){
+            if(!ifs || bytes > left)
+                throw runtime_error("truncated journal index: " + filename);
+            left -= bytes;
+        };
+        take(16);
+        if(read_u32(ifs) != kMagic || read_u32(ifs) != kVersion)
+            throw runtime_error("not a journal index: " + filename);
+        JournalIndex index;
+        index.doc_count = read_u32(ifs);
+        uint32_t terms = read_u32(ifs);
+        for(uint32_t t = 0; t < terms; ++t){
+            take(4);
+            uint32_t word_length = read_u32(ifs);
+            take(uint64_t(word_length) + 12);
+            string word(word_length, '\0');
+            ifs.read(word.data(), streamsize(word.size()));
+            Posting p;
+            p.count = read_u32(ifs);
+            p.last = read_u32(ifs);
+            uint32_t byte_length = read_u32(ifs);
+            take(byte_length);
+            p.bytes.resize(byte_length);
+            ifs.read(reinterpret_cast<char*>(p.bytes.data()), streamsize(p.bytes.size()));
+            if(!valid_posting(p, index.doc_count))
+                throw runtime_error("corrupt posting for \"" + word + "\" in journal index: " + filename);
+            index.postings.emplace_hint(index.postings.end(), std::move(word), std::move(p));
+        }
+        if(!ifs)
+            throw runtime_error("truncated journal index: " + filename);
+        return index;
+    }
+
+private:
+    static constexpr uint32_t kMagic = 0x5844494a;  // "JIDX"
+    static constexpr uint32_t kVersion = 1;
+
+    struct Posting{
+        vector<uint8_t> bytes;  // varint gaps between entry positions
+        uint32_t count = 0;
+        uint32_t last = 0;
+    };
+
+    void add(const string& line)
+    {
+        uint32_t doc = uint32_t(doc_count++);
+        size_t colon = line.find(": ");
+        string_view text(line);
+        if(colon != string::npos)
+            text.remove_prefix(colon + 2);
+
+        string word;
+        for(size_t i = 0; i <= text.size(); ++i){
+            if(i < text.size() && isalnum(static_cast<unsigned char>(text[i]))){
+                word.push_back(char(tolower(static_cast<unsigned char>(text[i]))));
+                continue;
+            }
+            if(word.empty())
+                continue;
+            Posting& p = postings[word];
+            if(p.count == 0 || p.last != doc){
+                put_varint(p.bytes, p.count == 0 ? doc : doc - p.last);
+                p.last = doc;
+                ++p.count;
+            }
+            word.clear();
+        }
+    }
+
+    static string normalize(string_view word)
+    {
+        string out;
+        out.reserve(word.size());
+        for(char c : word)
+            out.push_back(char(tolower(static_cast<unsigned char>(c))));
+        return out;
+    }
+
+    static void put_varint(vector<uint8_t>& out, uint32_t v)
+    {
+        while(v >= 0x80){
+            out.push_back(uint8_t(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(uint8_t(v));
+    }
+
+    // calls fn(doc) for every entry position in p, in order
+    template<typename Fn>
+    static void for_each_doc(const Posting& p, Fn&& fn)
+    {
+        uint32_t doc = 0;
+        size_t i = 0;
+        bool first = true;
+        while(i < p.bytes.size()){
+            uint32_t v = 0;
+            for(int shift = 0;; shift += 7){
+                uint8_t b = p.bytes[i++];
+                v |= uint32_t(b & 0x7f) << shift;
+                if(!(b & 0x80))
+                    break;
+            }
+            doc = first ? v : doc + v;
+            first = false;
+            fn(doc);
+        }
+    }
+
+    // what add() would have produced: varints that end inside the bytes,
+    // increasing entry positions below doc_count, and matching count and last
+    static bool valid_posting(const Posting& p, size_t doc_count)
+    {
+        uint64_t doc = 0;
+        uint32_t count = 0;
+        size_t i = 0;
+        while(i < p.bytes.size()){
+            uint64_t v = 0;
+            for(int shift = 0;; shift += 7){
+                if(i == p.bytes.size() || shift > 28)
+                    return false;
+                uint8_t b = p.bytes[i++];
+                v |= uint64_t(b & 0x7f) << shift;
+                if(!(b & 0x80))
+                    break;
+            }
+            if(count > 0 && v == 0)
+                return false;
+            doc = count == 0 ? v : doc + v;
+            if(doc >= doc_count)
+                return false;
+            ++count;
+        }
+        return count > 0 && count == p.count && doc == p.last;
+    }
+
+    static vector<uint32_t> decode(const Posting& p)
+    {
+        vector<uint32_t> docs;
+        docs.reserve(p.count);
+        for_each_doc(p, [&](uint32_t doc){ docs.push_back(doc); });
+        return docs;
+    }
+
+    // OR of many posting lists in one pass, instead of one merge per list.
+    // Broad unions mark a bitmap over all entries; narrow ones sort and dedupe.
+    vector<uint32_t> union_of(const vector<const Posting*>& lists) const
+    {
+        size_t total = 0;
+        for(auto* p : lists)
+            total += p->count;
+        vector<uint32_t> out;
+        if(total * 8 >= doc_count){
+            vector<uint64_t> seen((doc_count + 63) / 64);
+            for(auto* p : lists)
+                for_each_doc(*p, [&](uint32_t doc){ seen[doc >> 6] |= uint64_t(1) << (doc & 63); });
+            for(size_t w = 0; w < seen.size(); ++w)
+                for(uint64_t bits = seen[w]; bits; bits &= bits - 1)
+                    out.push_back(uint32_t(w * 64 + size_t(__builtin_ctzll(bits))));
+            return out;
+        }
+        out.reserve(total);
+        for(auto* p : lists)
+            for_each_doc(*p, [&](uint32_t doc){ out.push_back(doc); });
+        if(lists.size() > 1){
+            sort(out.begin(), out.end());
+            out.erase(unique(out.begin(), out.end()), out.end());
+        }
+        return out;
+    }
+
+    // keeps the entries of sorted that also appear in p, decoding p as it goes
+    static vector<uint32_t> intersect(const vector<uint32_t>& sorted, const Posting& p)
+    {
+        vector<uint32_t> out;
+        size_t i = 0, k = 0;
+        uint32_t doc = 0;
+        bool first = true;
+        while(i < p.bytes.size() && k < sorted.size()){
+            uint32_t v = 0;
+            for(int shift = 0;; shift += 7){
+                uint8_t b = p.bytes[i++];
+                v |= uint32_t(b & 0x7f) << shift;
+                if(!(b & 0x80))
+                    break;
+            }
+            doc = first ? v : doc + v;
+            first = false;
+            while(k < sorted.size() && sorted[k] < doc)
+                ++k;
+            if(k < sorted.size() && sorted[k] == doc)
+                out.push_back(sorted[k++]);
+        }
+        return out;
+    }
+
+    static void write_u32(ofstream& ofs, uint32_t v) { ofs.write(reinterpret_cast<const char*>(&v), sizeof v); }
+
+    static uint32_t read_u32(ifstream& ifs)
+    {
+        uint32_t v = 0;
+        ifs.read(reinterpret_cast<char*>(&v), sizeof v);
+        return v;
+    }
+
+    map<string, Posting, less<>> postings;
+    size_t doc_count = 0;
+    Journal::Subscription subscription;
+};
+
+/*
+int main(){
+    Journal journal{"Dear Diary"};
+    JournalIndex index;
+    index.attach(journal);
+
+    journal.add_entry("I see a bug");
+    journal.add_entry("I walked 5 miles today");
+
+    for(auto doc : index.all_of({"walked", "miles"}))
+        cout << journal.entries[doc] << endl;
+
+    PersistenceManager::save(journal, "diary.txt");
+    index.save("diary.txt.idx");
+}
+*/
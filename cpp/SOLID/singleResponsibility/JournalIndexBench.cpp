@@ -0,0 +1,130 @@
+// query latency of JournalIndex against a linear scan of Journal::entries
+// usage: JournalIndexBench [entries] [directory]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "JournalIndex.cpp"
+
+using namespace std;
+using bench_clock = chrono::steady_clock;
+
+template <typename Fn>
+double time_us(Fn&& fn)
+{
+    auto start = bench_clock::now();
+    fn();
+    return chrono::duration<double, micro>(bench_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]){
+    size_t entries = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    string dir = argc > 2 ? argv[2] : "/tmp";
+
+    // Zipf-ish vocabulary: a few very common words and a long tail
+    vector<string> vocab;
+    for(int i = 0; i < 20000; ++i)
+        vocab.push_back("w" + to_string(i));
+    const char* common[] = {"patrol", "checkpoint", "contact", "supply", "weather", "bug", "miles", "radio"};
+    mt19937 rng(3);
+    auto pick = [&]{
+        uniform_real_distribution<double> u(0, 1);
+        double r = u(rng);
+        if(r < 0.5)
+            return string(common[rng() % 8]);
+        return vocab[size_t(double(vocab.size()) * r * r) % vocab.size()];
+    };
+
+    Journal journal{"bench"};
+    JournalIndex index;
+    index.attach(journal);
+    double build_us = time_us([&]{
+        for(size_t i = 0; i < entries; ++i){
+            string text;
+            for(int k = 0; k < 8; ++k)
+                text += pick() + " ";
+            journal.add_entry(text);
+        }
+    });
+
+    auto scan = [&](const string& word){
+        vector<uint32_t> docs;
+        for(size_t i = 0; i < journal.entries.size(); ++i)
+            if(journal.entries[i].find(word) != string::npos)
+                docs.push_back(uint32_t(i));
+        return docs;
+    };
+
+    size_t hits = 0;
+    double scan_us = time_us([&]{ hits = scan("w1234 ").size(); });
+    double term_us = time_us([&]{ hits += index.term("w1234").size(); });
+    double and_us = time_us([&]{ hits += index.all_of({"patrol", "radio", "w17"}).size(); });
+    double or_us = time_us([&]{ hits += index.any_of({"w1234", "w4321", "w9999"}).size(); });
+    double prefix_us = time_us([&]{ hits += index.prefix("w1999").size(); });
+    vector<uint32_t> broad;
+    double broad_us = time_us([&]{ broad = index.prefix("w1"); });
+    double all_words_us = time_us([&]{ hits += index.prefix("w").size(); });
+    size_t broad_terms = 0;
+    for(auto& w : vocab)
+        broad_terms += w.compare(0, 2, "w1") == 0;
+    vector<uint32_t> broad_scan = scan(" w1");
+
+    string path = dir + "/journal_bench.txt.idx";
+    double save_us = time_us([&]{ index.save(path); });
+    JournalIndex loaded;
+    double load_us = time_us([&]{ loaded = JournalIndex::load(path); });
+    bool same = loaded.all_of({"patrol", "radio", "w17"}) == index.all_of({"patrol", "radio", "w17"});
+
+    // a damaged or foreign index file is rejected on load, never decoded
+    auto rejects = [&](const vector<uint32_t>& words, const vector<uint8_t>& posting){
+        {
+            ofstream ofs(path, ios::binary | ios::trunc);
+            ofs.write(reinterpret_cast<const char*>(words.data()), streamsize(words.size() * 4));
+            ofs.write(reinterpret_cast<const char*>(posting.data()), streamsize(posting.size()));
+        }
+        try{
+            JournalIndex::load(path);
+        }catch(const runtime_error&){
+            return true;
+        }
+        return false;
+    };
+    // magic, version, doc_count, terms, then one 4-byte term: length, bytes, count, last, byte length
+    const uint32_t magic = 0x5844494a, ab = 'a' | 'b' << 8;
+    bool hardened = rejects({magic, 1, 10, 1, 4, ab, 1, 0, 1}, {0x80})                  // varint runs off the end
+                    && rejects({magic, 1, 10, 1, 4, ab, 1, 12, 1}, {12})                // entry beyond doc_count
+                    && rejects({magic, 1, 10, 1, 4, ab, 1, 0, 0xffffff00}, {0})         // length beyond the file
+                    && rejects({magic, 1, 10, 0xffffffff, 0xfffffff0}, {});             // absurd term count
+    bool accepts_valid = !rejects({magic, 1, 10, 1, 4, ab, 2, 7, 2}, {3, 4});
+    bool foreign_rejected = false;
+    try{
+        Journal shorter{"shorter"};
+        shorter.add_entry("patrol");
+        loaded.attach(shorter);
+    }catch(const runtime_error&){
+        foreign_rejected = true;
+    }
+    remove(path.c_str());
+
+    cout << entries << " entries, " << index.term_count() << " terms, indexed during append in "
+         << build_us / 1e3 << " ms (checksum " << hits << ")\n";
+    cout << "linear scan, one word : " << scan_us << " us\n";
+    cout << "term                  : " << term_us << " us\n";
+    cout << "AND of 3 terms        : " << and_us << " us\n";
+    cout << "OR of 3 terms         : " << or_us << " us\n";
+    cout << "prefix w1999*         : " << prefix_us << " us\n";
+    cout << "prefix w1* (" << broad_terms << " terms): " << broad_us << " us, " << broad.size() << " entries"
+         << (broad == broad_scan ? "" : " (DIFFERS FROM SCAN)") << "\n";
+    cout << "prefix w* (" << vocab.size() << " terms) : " << all_words_us << " us\n";
+    cout << "save " << save_us / 1e3 << " ms, load " << load_us / 1e3 << " ms"
+         << (same ? "" : " (LOADED INDEX DIFFERS)") << "\n";
+    cout << "damaged index files   : " << (hardened && accepts_valid ? "rejected" : "NOT REJECTED")
+         << ", index of a longer journal " << (foreign_rejected ? "rejected" : "ACCEPTED") << "\n";
+    return same && hardened && accepts_valid && foreign_rejected ? 0 : 1;
+}
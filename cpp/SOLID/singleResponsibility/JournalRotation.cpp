@@ -0,0 +1,396 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include "Journal.cpp"
+#include "LzBlockCodec.cpp"
+
+using namespace std;
+
+// Segment rotation: instead of one ever-growing diary.txt, lines go to an
+// active text segment (base.000001.log, base.000002.log, ...). When the
+// active segment reaches its size or age limit it is sealed and a new one
+// is started. Both limits are checked when a line is appended, so a segment
+// that receives nothing stays open, whatever its age, until the next
+// append or rotate(). A background thread compresses each sealed segment
+// into base.NNNNNN.lzj and removes the .log, so add_entry never waits on
+// compression. A writer started on a base that already has segments
+// numbers its own after the highest one on disk and never overwrites them.
+//
+// .lzj layout (integers little-endian)
+//   header     magic "JLZB", u32 version, u64 entry_count, u32 block_count,
+//              u32 reserved
+//   directory  per block: u64 first_entry, u64 file_offset,
+//              u32 compressed_size, u32 raw_size
+//   blocks     LzBlockCodec blocks, each holding whole '\n'-terminated lines
+// Blocks are compressed independently, so CompressedSegment reads entry n
+// by decompressing the one block that holds it.
+
+struct RotationPolicy{
+    uint64_t max_segment_bytes = 64 << 20;
+    chrono::seconds max_segment_age{3600};
+    size_t block_bytes = 64 << 10;          // raw bytes per compressed block
+};
+
+struct CompressedSegmentHeader{
+    char magic[4];
+    uint32_t version;
+    uint64_t entry_count;
+    uint32_t block_count;
+    uint32_t reserved;
+};
+
+struct CompressedBlockInfo{
+    uint64_t first_entry;
+    uint64_t file_offset;
+    uint32_t compressed_size;
+    uint32_t raw_size;
+};
+
+static_assert(sizeof(CompressedSegmentHeader) == 24 && sizeof(CompressedBlockInfo) == 24,
+              "segment layout must not depend on padding");
+
+// compresses a sealed text segment; returns the number of bytes written
+inline uint64_t compress_segment(const string& log_path, const string& lzj_path, size_t block_bytes)
+{
+    ifstream in(log_path, ios::binary);
+    if(!in)
+        throw runtime_error("cannot read segment " + log_path);
+
+    vector<CompressedBlockInfo> blocks;
+    vector<string> payloads;
+    uint64_t entries = 0;
+    string raw, line;
+    uint64_t block_first = 0;
+    auto seal_block = [&]{
+        payloads.push_back(LzBlockCodec::compress(raw.data(), raw.size()));
+        blocks.push_back({block_first, 0, uint32_t(payloads.back().size()), uint32_t(raw.size())});
+        raw.clear();
+    };
+    while(getline(in, line)){
+        if(raw.empty())
+            block_first = entries;
+        raw.append(line).push_back('\n');
+        ++entries;
+        if(raw.size() >= block_bytes)
+            seal_block();
+    }
+    if(!raw.empty())
+        seal_block();
+
+    CompressedSegmentHeader header{{'J', 'L', 'Z', 'B'}, 1, entries, uint32_t(blocks.size()), 0};
+    uint64_t offset = sizeof header + blocks.size() * sizeof(CompressedBlockInfo);
+    for(auto& b : blocks){
+        b.file_offset = offset;
+        offset += b.compressed_size;
+    }
+
+    string tmp = lzj_path + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof header);
+        out.write(reinterpret_cast<const char*>(blocks.data()), streamsize(blocks.size() * sizeof(CompressedBlockInfo)));
+        for(auto& p : payloads)
+            out.write(p.data(), streamsize(p.size()));
+        if(!out)
+            throw runtime_error("failed writing " + tmp);
+    }
+    // the .lzj appears complete or not at all; link() refuses to replace one
+    if(::link(tmp.c_str(), lzj_path.c_str()) != 0){
+        int failure = errno;
+        remove(tmp.c_str());
+        throw runtime_error(failure == EEXIST ? lzj_path + " already exists" : "cannot publish " + lzj_path);
+    }
+    remove(tmp.c_str());
+    return offset;
+}
+
+// highest N among base.N.log and base.N.lzj on disk, or 0 if there are none
+inline uint64_t last_segment_sequence(const string& base)
+{
+    size_t slash = base.rfind('/');
+    string dir = slash == string::npos ? "." : base.substr(0, slash + 1);
+    string prefix = base.substr(slash == string::npos ? 0 : slash + 1) + ".";
+    DIR* listing = ::opendir(dir.c_str());
+    if(!listing)
+        throw runtime_error("cannot list " + dir);
+    uint64_t last = 0;
+    while(dirent* e = ::readdir(listing)){
+        string_view name = e->d_name;
+        if(name.size() <= prefix.size() + 4 || name.compare(0, prefix.size(), prefix) != 0)
+            continue;
+        string_view extension = name.substr(name.size() - 4);
+        string_view digits = name.substr(prefix.size(), name.size() - prefix.size() - 4);
+        if((extension != ".log" && extension != ".lzj") || digits.size() > 19
+           || !all_of(digits.begin(), digits.end(), [](char c){ return c >= '0' && c <= '9'; }))
+            continue;
+        last = max(last, uint64_t(stoull(string(digits))));
+    }
+    ::closedir(listing);
+    return last;
+}
+
+// random access to a compressed segment; keeps the last block decompressed
+class CompressedSegment{
+public:
+    explicit CompressedSegment(const string& path) : in(path, ios::binary)
+    {
+        if(!in.read(reinterpret_cast<char*>(&header), sizeof header) || memcmp(header.magic, "JLZB", 4) != 0
+           || header.version != 1)
+            throw runtime_error("not a compressed journal segment: " + path);
+        blocks.resize(header.block_count);
+        if(!in.read(reinterpret_cast<char*>(blocks.data()), streamsize(blocks.size() * sizeof(CompressedBlockInfo))))
+            throw runtime_error("truncated segment directory: " + path);
+    }
+
+    size_t size() const { return size_t(header.entry_count); }
+    size_t block_count() const { return blocks.size(); }
+
+    string entry(size_t n)
+    {
+        if(n >= size())
+            throw out_of_range("segment entry out of range");
+        // last block whose first entry is <= n
+        size_t b = size_t(upper_bound(blocks.begin(), blocks.end(), uint64_t(n),
+                          [](uint64_t v, const CompressedBlockInfo& info){ return v < info.first_entry; })
+                          - blocks.begin()) - 1;
+        if(b != cached_block){
+            const auto& info = blocks[b];
+            string packed(info.compressed_size, '\0');
+            in.seekg(streamoff(info.file_offset));
+            if(!in.read(packed.data(), streamsize(packed.size())))
+                throw runtime_error("truncated segment block");
+            cached = LzBlockCodec::decompress(packed.data(), packed.size(), info.raw_size);
+            cached_block = b;
+            line_starts.clear();
+            for(size_t pos = 0; pos < cached.size(); pos = cached.find('\n', pos) + 1)
+                line_starts.push_back(pos);
+        }
+        size_t k = n - size_t(blocks[b].first_entry);
+        if(k >= line_starts.size())
+            throw runtime_error("corrupt segment block");
+        size_t start = line_starts[k];
+        return cached.substr(start, cached.find('\n', start) - start);
+    }
+
+private:
+    ifstream in;
+    CompressedSegmentHeader header{};
+    vector<CompressedBlockInfo> blocks;
+    size_t cached_block = size_t(-1);
+    string cached;
+    vector<size_t> line_starts;
+};
+
+class RotatingJournalWriter{
+public:
+    RotatingJournalWriter(string base_path, RotationPolicy policy = {})
+        : base(std::move(base_path)), policy(policy), sequence(last_segment_sequence(base) + 1)
+    {
+        // the segment first: if it cannot be created there is no thread to stop
+        open_segment();
+        try{
+            compressor = thread([this]{ compress_loop(); });
+        }catch(...){
+            active.close();
+            remove(segment_path(sequence, ".log").c_str());
+            throw;
+        }
+    }
+
+    ~RotatingJournalWriter()
+    {
+        detach();
+        // hands the last segment to the compressor without starting another
+        if(active.is_open()){
+            if(active_bytes > 0){
+                try{
+                    seal();
+                }catch(...){
+                    // the .log stays on disk and is still readable as text
+                }
+            }else{
+                active.close();
+                remove(segment_path(sequence, ".log").c_str());
+            }
+        }
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        work.notify_one();
+        compressor.join();
+    }
+
+    RotatingJournalWriter(const RotatingJournalWriter&) = delete;
+    RotatingJournalWriter& operator=(const RotatingJournalWriter&) = delete;
+
+    // follows j until detach() or destruction; replaces any journal attached before
+    void attach(Journal& j)
+    {
+        subscription = j.subscribe([this](const string& line){ append(line); });
+    }
+
+    void detach() { subscription.reset(); }
+
+    // writes to the active text segment only; compression happens elsewhere
+    void append(const string& line)
+    {
+        if(!active.is_open())
+            open_segment();     // an earlier rotate() could not start one
+        active.write(line.data(), streamsize(line.size()));
+        active.put('\n');
+        active_bytes += line.size() + 1;
+        if(active_bytes >= policy.max_segment_bytes || chrono::steady_clock::now() - opened >= policy.max_segment_age)
+            rotate();
+    }
+
+    // seals the active segment (if it has anything) and starts a new one
+    void rotate()
+    {
+        if(active_bytes == 0)
+            return;
+        seal();
+        ++sequence;
+        open_segment();
+    }
+
+    // blocks until every sealed segment has been compressed
+    void wait_idle()
+    {
+        unique_lock<mutex> lock(m);
+        idle.wait(lock, [&]{ return queue.empty() && !busy; });
+        if(!error.empty())
+            throw runtime_error(error);
+    }
+
+    // compressed segments in order, and the bytes they take
+    vector<string> sealed_segments() const
+    {
+        lock_guard<mutex> lock(m);
+        return sealed;
+    }
+
+    uint64_t compressed_bytes() const
+    {
+        lock_guard<mutex> lock(m);
+        return sealed_bytes;
+    }
+
+    string segment_path(uint64_t n, const char* extension) const
+    {
+        char number[16];
+        snprintf(number, sizeof number, ".%06llu", static_cast<unsigned long long>(n));
+        return base + number + extension;
+    }
+
+private:
+    void seal()
+    {
+        active.close();
+        active_bytes = 0;
+        {
+            lock_guard<mutex> lock(m);
+            queue.push_back(segment_path(sequence, ".log"));
+        }
+        work.notify_one();
+    }
+
+    void open_segment()
+    {
+        string path = segment_path(sequence, ".log");
+        if(::access(path.c_str(), F_OK) == 0 || ::access(segment_path(sequence, ".lzj").c_str(), F_OK) == 0)
+            throw runtime_error("segment " + path + " already exists");
+        active.open(path, ios::binary | ios::trunc);
+        if(!active)
+            throw runtime_error("cannot create segment " + path);
+        active_bytes = 0;
+        opened = chrono::steady_clock::now();
+    }
+
+    void compress_loop()
+    {
+        unique_lock<mutex> lock(m);
+        for(;;){
+            work.wait(lock, [&]{ return stopping || !queue.empty(); });
+            if(queue.empty())
+                return;
+            string log_path = queue.front();
+            queue.pop_front();
+            busy = true;
+            lock.unlock();
+
+            string lzj_path = log_path.substr(0, log_path.size() - 4) + ".lzj";
+            uint64_t bytes = 0;
+            string failure;
+            try{
+                bytes = compress_segment(log_path, lzj_path, policy.block_bytes);
+                remove(log_path.c_str());
+            }catch(const exception& e){
+                failure = e.what();     // the .log is kept, so nothing is lost
+            }
+
+            lock.lock();
+            busy = false;
+            if(failure.empty()){
+                sealed.push_back(lzj_path);
+                sealed_bytes += bytes;
+            }else if(error.empty()){
+                error = failure;
+            }
+            idle.notify_all();
+        }
+    }
+
+    string base;
+    RotationPolicy policy;
+    uint64_t sequence;
+    ofstream active;
+    uint64_t active_bytes = 0;
+    chrono::steady_clock::time_point opened;
+
+    mutable mutex m;
+    condition_variable work;
+    condition_variable idle;
+    deque<string> queue;
+    vector<string> sealed;
+    uint64_t sealed_bytes = 0;
+    bool busy = false;
+    bool stopping = false;
+    string error;
+    Journal::Subscription subscription;
+    thread compressor;
+};
+
+/*
+int main(){
+    Journal journal{"Dear Diary"};
+    RotationPolicy policy;
+    policy.max_segment_bytes = 1 << 20;
+    RotatingJournalWriter writer("diary", policy);
+    writer.attach(journal);
+
+    journal.add_entry("I see a bug");
+    writer.rotate();
+    writer.wait_idle();
+
+    CompressedSegment segment(writer.sealed_segments().front());
+    cout << segment.entry(0) << endl;    // "1: I see a bug"
+}
+*/
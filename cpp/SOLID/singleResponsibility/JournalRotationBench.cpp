@@ -0,0 +1,131 @@
+// segment rotation with block compression: ratio and throughput on a
+// journal-like workload
+// usage: JournalRotationBench [entries] [directory]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "JournalRotation.cpp"
+
+using namespace std;
+using bench_clock = chrono::steady_clock;
+
+template <typename Fn>
+double time_s(Fn&& fn)
+{
+    auto start = bench_clock::now();
+    fn();
+    return chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]){
+    size_t entries = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    string dir = argc > 2 ? argv[2] : "/tmp";
+
+    const char* events[] = {"reached checkpoint and reported no contact", "requested resupply of ammo",
+                            "observed vehicle movement to the north", "radio check, signal good",
+                            "medic treated minor injury", "engineer cleared obstacle on route"};
+    mt19937 rng(11);
+    vector<string> texts;
+    texts.reserve(entries);
+    uint64_t raw_bytes = 0;
+    for(size_t i = 0; i < entries; ++i){
+        texts.push_back("Squad " + to_string(rng() % 40) + " " + events[rng() % 6] + " at grid " + to_string(rng() % 100000));
+        raw_bytes += texts.back().size() + to_string(i + 1).size() + 3;
+    }
+
+    // one growing file, as PersistenceManager produces
+    string plain_path = dir + "/journal_bench_plain.txt";
+    double plain_s = time_s([&]{
+        Journal journal{"plain"};
+        ofstream out(plain_path, ios::binary | ios::trunc);
+        auto following = journal.subscribe([&](const string& line){ out << line << '\n'; });
+        for(auto& t : texts)
+            journal.add_entry(t);
+    });
+    remove(plain_path.c_str());
+
+    RotationPolicy policy;
+    policy.max_segment_bytes = 16 << 20;
+    auto writer = make_unique<RotatingJournalWriter>(dir + "/journal_bench", policy);
+    double append_s = 0, drain_s = 0;
+    {
+        Journal journal{"rotating"};
+        writer->attach(journal);
+        append_s = time_s([&]{
+            for(auto& t : texts)
+                journal.add_entry(t);
+        });
+        drain_s = time_s([&]{
+            writer->rotate();
+            writer->wait_idle();
+        });
+    }
+    vector<string> segments = writer->sealed_segments();
+    uint64_t packed_bytes = writer->compressed_bytes();
+    writer.reset();
+
+    vector<unique_ptr<CompressedSegment>> readers;
+    vector<size_t> first_entry;
+    size_t total = 0;
+    for(auto& path : segments){
+        readers.push_back(make_unique<CompressedSegment>(path));
+        first_entry.push_back(total);
+        total += readers.back()->size();
+    }
+
+    size_t checksum = 0;
+    const size_t lookups = 20000;
+    double random_s = time_s([&]{
+        for(size_t i = 0; i < lookups; ++i){
+            size_t n = rng() % total;
+            size_t s = size_t(upper_bound(first_entry.begin(), first_entry.end(), n) - first_entry.begin()) - 1;
+            checksum += readers[s]->entry(n - first_entry[s]).size();
+        }
+    });
+    double scan_s = time_s([&]{
+        for(auto& r : readers)
+            for(size_t i = 0; i < r->size(); ++i)
+                checksum += r->entry(i).size();
+    });
+    bool last_ok = readers.back()->entry(readers.back()->size() - 1) == to_string(entries) + ": " + texts.back();
+
+    // a second writer on the same base continues after the existing segments
+    vector<string> restarted;
+    {
+        RotatingJournalWriter again(dir + "/journal_bench", policy);
+        Journal journal{"restarted"};
+        again.attach(journal);
+        journal.add_entry("after restart");
+        again.rotate();
+        again.wait_idle();
+        restarted = again.sealed_segments();
+    }
+    bool restart_ok = restarted.size() == 1 && restarted[0] > segments.back()
+                      && CompressedSegment(segments.front()).size() == readers.front()->size()
+                      && CompressedSegment(restarted[0]).entry(0) == "1: after restart";
+
+    double mb = double(raw_bytes) / 1e6;
+
+    cout << entries << " entries, " << mb << " MB raw, " << segments.size() << " segments\n";
+    cout << "compression ratio      : " << double(raw_bytes) / double(packed_bytes) << "x\n";
+    cout << "append, single file    : " << mb / plain_s << " MB/s\n";
+    cout << "append, rotating       : " << mb / append_s << " MB/s (compression on background thread)\n";
+    cout << "compression backlog    : " << drain_s * 1e3 << " ms after the last append\n";
+    cout << "random entry read      : " << random_s * 1e6 / double(lookups) << " us/entry\n";
+    cout << "sequential read        : " << mb / scan_s << " MB/s (checksum " << checksum << ")\n";
+    cout << "last entry round trip  : " << (last_ok ? "ok" : "MISMATCH") << "\n";
+    cout << "restart on same base   : " << (restart_ok ? "existing segments kept" : "SEGMENTS OVERWRITTEN") << "\n";
+    for(auto& path : segments)
+        remove(path.c_str());
+    for(auto& path : restarted)
+        remove(path.c_str());
+    return last_ok && restart_ok ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Journal.cpp"
+
+using namespace std;
+
+// Binary journal segment: loading is a concern of its own, kept apart from
+// Journal the same way PersistenceManager is.
+//
+// layout (all integers little-endian)
+//   header   magic "JSEG", u16 version, u16 flags, u64 entry_count,
+//            u64 index_offset, u32 title_length, u32 reserved     (32 bytes)
+//   title    title_length bytes
+//   entries  per entry: u32 length, then the entry bytes
+//   index    entry_count u64 offsets, each pointing at an entry's length
+//
+// JournalSegment maps the file and hands entries out as string_views into
+// the mapping: opening reads only the header, and entry(n) is one index
+// lookup, whatever the file size.
+
+struct SegmentHeader{
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint64_t entry_count;
+    uint64_t index_offset;
+    uint32_t title_length;
+    uint32_t reserved;
+};
+static_assert(sizeof(SegmentHeader) == 32, "segment header must stay 32 bytes");
+
+constexpr uint16_t kSegmentVersion = 1;
+
+inline bool host_is_little_endian()
+{
+    const uint16_t probe = 1;
+    unsigned char first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+struct SegmentPersistenceManager{
+    static void save(const Journal& j, const string& filename)
+    {
+        if(!host_is_little_endian())
+            throw runtime_error("journal segments are only written on little-endian hosts");
+        // lengths are stored as u32; checked before the file is touched
+        constexpr size_t max_length = numeric_limits<uint32_t>::max();
+        if(j.title.size() > max_length)
+            throw length_error("journal title too long for a segment");
+        for(auto& s : j.entries)
+            if(s.size() > max_length)
+                throw length_error("journal entry too long for a segment");
+
+        ofstream ofs(filename, ios::binary | ios::trunc);
+        if(!ofs)
+            throw runtime_error("cannot create segment " + filename);
+
+        SegmentHeader header{{'J', 'S', 'E', 'G'}, kSegmentVersion, 0, j.entries.size(), 0,
+                             uint32_t(j.title.size()), 0};
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof header);
+        ofs.write(j.title.data(), streamsize(j.title.size()));
+
+        vector<uint64_t> index;
+        index.reserve(j.entries.size());
+        uint64_t offset = sizeof header + j.title.size();
+        for(auto& s : j.entries){
+            uint32_t length = uint32_t(s.size());
+            index.push_back(offset);
+            ofs.write(reinterpret_cast<const char*>(&length), sizeof length);
+            ofs.write(s.data(), streamsize(s.size()));
+            offset += sizeof length + s.size();
+        }
+
+        header.index_offset = offset;
+        ofs.write(reinterpret_cast<const char*>(index.data()), streamsize(index.size() * sizeof(uint64_t)));
+        ofs.seekp(0);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof header);
+        if(!ofs)
+            throw runtime_error("failed writing segment " + filename);
+    }
+
+    // copies a segment back into a Journal; entry numbers are kept as stored
+    static Journal load(const string& filename);
+};
+
+// read-only view of a segment file; entries stay valid while it is open
+class JournalSegment{
+public:
+    explicit JournalSegment(const string& filename)
+    {
+        if(!host_is_little_endian())
+            throw runtime_error("journal segments are only read on little-endian hosts");
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if(fd < 0)
+            throw runtime_error("cannot open segment " + filename);
+        struct stat st{};
+        if(::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(SegmentHeader)){
+            ::close(fd);
+            throw runtime_error("not a journal segment: " + filename);
+        }
+        length = size_t(st.st_size);
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(p == MAP_FAILED)
+            throw runtime_error("cannot map segment " + filename);
+        base = static_cast<const char*>(p);
+
+        memcpy(&header, base, sizeof header);
+        if(memcmp(header.magic, "JSEG", 4) != 0 || header.version != kSegmentVersion
+           || sizeof header + header.title_length > length
+           || header.index_offset > length
+           || header.entry_count > (length - header.index_offset) / sizeof(uint64_t)){
+            ::munmap(const_cast<char*>(base), length);
+            throw runtime_error("corrupt or unsupported segment " + filename);
+        }
+        index = base + header.index_offset;
+    }
+
+    ~JournalSegment()
+    {
+        if(base)
+            ::munmap(const_cast<char*>(base), length);
+    }
+
+    JournalSegment(const JournalSegment&) = delete;
+    JournalSegment& operator=(const JournalSegment&) = delete;
+
+    size_t size() const { return size_t(header.entry_count); }
+
+    string_view title() const { return {base + sizeof header, header.title_length}; }
+
+    // entry n as stored ("N: text"), without copying
+    string_view entry(size_t n) const
+    {
+        if(n >= size())
+            throw out_of_range("segment entry out of range");
+        uint64_t offset;
+        memcpy(&offset, index + n * sizeof offset, sizeof offset);
+        uint32_t entry_length;
+        // compared against what is left, so a wild offset cannot wrap the sum
+        if(header.index_offset < sizeof entry_length || offset > header.index_offset - sizeof entry_length)
+            throw runtime_error("corrupt segment index");
+        memcpy(&entry_length, base + offset, sizeof entry_length);
+        if(entry_length > header.index_offset - sizeof entry_length - offset)
+            throw runtime_error("corrupt segment entry");
+        return {base + offset + sizeof entry_length, entry_length};
+    }
+
+    string_view operator[](size_t n) const { return entry(n); }
+
+private:
+    const char* base = nullptr;
+    size_t length = 0;
+    SegmentHeader header{};
+    const char* index = nullptr;
+};
+
+inline Journal SegmentPersistenceManager::load(const string& filename)
+{
+    JournalSegment segment(filename);
+    Journal j{string(segment.title())};
+    j.entries.reserve(segment.size());
+    for(size_t i = 0; i < segment.size(); ++i)
+        j.entries.emplace_back(segment.entry(i));
+    j.next_number = uint64_t(segment.size()) + 1;
+    return j;
+}
+
+/*
+int main(){
+    Journal journal{"Dear Diary"};
+    journal.add_entry("I see a bug");
+    journal.add_entry("I walked 5 miles today");
+    SegmentPersistenceManager::save(journal, "diary.seg");
+
+    JournalSegment segment("diary.seg");
+    cout << segment.title() << ": " << segment[1] << endl;   // "2: I walked 5 miles today"
+}
+*/
@@ -0,0 +1,88 @@
+// reopening a journal: parsing the text file versus mapping a segment
+// usage: JournalSegmentBench [entries] [directory]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "JournalSegment.cpp"
+
+using namespace std;
+using bench_clock = chrono::steady_clock;
+
+template <typename Fn>
+double time_ms(Fn&& fn)
+{
+    auto start = bench_clock::now();
+    fn();
+    return chrono::duration<double, milli>(bench_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]){
+    size_t entries = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    string dir = argc > 2 ? argv[2] : "/tmp";
+    string text_path = dir + "/journal_bench.txt";
+    string seg_path = dir + "/journal_bench.seg";
+
+    Journal journal{"bench"};
+    for(size_t i = 0; i < entries; ++i)
+        journal.add_entry("Patrol " + to_string(i % 97) + " reached checkpoint and reported no contact");
+
+    double text_save = time_ms([&]{ PersistenceManager::save(journal, text_path); });
+    double seg_save = time_ms([&]{ SegmentPersistenceManager::save(journal, seg_path); });
+
+    // text: the only way to reach entry n is to read every line before it
+    vector<string> lines;
+    double text_open = time_ms([&]{
+        ifstream ifs(text_path);
+        string line;
+        while(getline(ifs, line))
+            lines.push_back(line);
+    });
+
+    size_t checksum = 0;
+    mt19937_64 rng(7);
+    const size_t lookups = 1000000;
+    double seg_open = 0, seg_lookup = 0;
+    {
+        unique_ptr<JournalSegment> segment;
+        seg_open = time_ms([&]{ segment = make_unique<JournalSegment>(seg_path); });
+        seg_lookup = time_ms([&]{
+            for(size_t i = 0; i < lookups; ++i)
+                checksum += segment->entry(rng() % segment->size()).size();
+        });
+        if(segment->entry(entries - 1) != journal.entries.back() || lines.back() != journal.entries.back())
+            cout << "MISMATCH\n";
+    }
+
+    cout << entries << " entries\n";
+    cout << "save: text " << text_save << " ms, segment " << seg_save << " ms\n";
+    cout << "open: text (parse all) " << text_open << " ms, segment (mmap) " << seg_open << " ms\n";
+    cout << "random entry lookup: " << seg_lookup * 1e6 / lookups << " ns (checksum " << checksum << ")\n";
+
+    // an index offset near 2^64 must be rejected, not wrapped into range
+    {
+        fstream seg(seg_path, ios::binary | ios::in | ios::out);
+        SegmentHeader header;
+        seg.read(reinterpret_cast<char*>(&header), sizeof header);
+        const uint64_t wild = ~uint64_t(0) - 1;
+        seg.seekp(streamoff(header.index_offset));
+        seg.write(reinterpret_cast<const char*>(&wild), sizeof wild);
+    }
+    bool rejected = false;
+    try{
+        JournalSegment(seg_path).entry(0);
+    }catch(const runtime_error&){
+        rejected = true;
+    }
+    cout << "corrupt index offset: " << (rejected ? "rejected" : "ACCEPTED") << "\n";
+    remove(text_path.c_str());
+    remove(seg_path.c_str());
+    return rejected ? 0 : 1;
+}
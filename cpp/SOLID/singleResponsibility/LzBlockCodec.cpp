@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Small LZ77 block codec in the style of LZ4, kept in-tree so the journal
+// needs no external library.
+//
+// A block is a series of sequences:
+//   token      high nibble: literal count, low nibble: match length - 4
+//              (15 in either nibble means more length bytes follow, each
+//              added until one is below 255)
+//   literals   copied as-is
+//   offset     u16 little-endian distance back to the match
+// The final sequence has literals only and ends the block. Matches are
+// found through a hash of the next four bytes, which is fast and good
+// enough for journal text, where lines repeat a lot.
+
+struct LzBlockCodec{
+    static constexpr size_t kMinMatch = 4;
+    static constexpr size_t kHashBits = 14;
+    static constexpr size_t kMaxOffset = 65535;
+
+    static uint32_t read32(const char* p)
+    {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+
+    static uint32_t hash4(uint32_t v) { return (v * 2654435761u) >> (32 - kHashBits); }
+
+    static void put_length(string& out, size_t extra)
+    {
+        while(extra >= 255){
+            out.push_back(char(255));
+            extra -= 255;
+        }
+        out.push_back(char(extra));
+    }
+
+    static void put_sequence(string& out, const char* literals, size_t literal_count, size_t offset, size_t match_length)
+    {
+        size_t lit_nibble = literal_count < 15 ? literal_count : 15;
+        size_t match_code = match_length ? match_length - kMinMatch : 0;
+        size_t match_nibble = match_code < 15 ? match_code : 15;
+        out.push_back(char(lit_nibble << 4 | match_nibble));
+        if(lit_nibble == 15)
+            put_length(out, literal_count - 15);
+        out.append(literals, literal_count);
+        if(match_length == 0)
+            return;
+        out.push_back(char(offset & 0xff));
+        out.push_back(char(offset >> 8));
+        if(match_nibble == 15)
+            put_length(out, match_code - 15);
+    }
+
+    static string compress(const char* src, size_t n)
+    {
+        string out;
+        out.reserve(n / 2 + 16);
+        vector<uint32_t> table(size_t(1) << kHashBits, 0);   // position + 1, 0 = empty
+        size_t anchor = 0;
+        size_t i = 0;
+        while(n >= kMinMatch && i <= n - kMinMatch){
+            uint32_t v = read32(src + i);
+            uint32_t& slot = table[hash4(v)];
+            size_t ref = slot;
+            slot = uint32_t(i + 1);
+            if(ref == 0 || i - (ref - 1) > kMaxOffset || read32(src + ref - 1) != v){
+                ++i;
+                continue;
+            }
+            ref -= 1;
+            size_t length = kMinMatch;
+            while(i + length < n && src[ref + length] == src[i + length])
+                ++length;
+            put_sequence(out, src + anchor, i - anchor, i - ref, length);
+            i += length;
+            anchor = i;
+        }
+        put_sequence(out, src + anchor, n - anchor, 0, 0);
+        return out;
+    }
+
+    static size_t get_length(const uint8_t*& ip, const uint8_t* end)
+    {
+        size_t total = 0;
+        uint8_t b;
+        do{
+            if(ip >= end)
+                throw runtime_error("LzBlockCodec: truncated length");
+            b = *ip++;
+            total += b;
+        }while(b == 255);
+        return total;
+    }
+
+    // raw_size must be the exact decompressed size, stored next to the block
+    static string decompress(const char* src, size_t n, size_t raw_size)
+    {
+        string out(raw_size, '\0');
+        char* op = out.data();
+        char* const oend = op + raw_size;
+        auto ip = reinterpret_cast<const uint8_t*>(src);
+        const uint8_t* const iend = ip + n;
+        while(ip < iend){
+            uint8_t token = *ip++;
+            size_t literals = token >> 4;
+            if(literals == 15)
+                literals += get_length(ip, iend);
+            if(size_t(iend - ip) < literals || size_t(oend - op) < literals)
+                throw runtime_error("LzBlockCodec: literals out of bounds");
+            memcpy(op, ip, literals);
+            op += literals;
+            ip += literals;
+            if(ip == iend)
+                break;
+            if(iend - ip < 2)
+                throw runtime_error("LzBlockCodec: truncated offset");
+            size_t offset = size_t(ip[0]) | size_t(ip[1]) << 8;
+            ip += 2;
+            size_t length = (token & 15) + kMinMatch;
+            if((token & 15) == 15)
+                length += get_length(ip, iend);
+            if(offset == 0 || offset > size_t(op - out.data()) || size_t(oend - op) < length)
+                throw runtime_error("LzBlockCodec: match out of bounds");
+            const char* match = op - offset;
+            for(size_t k = 0; k < length; ++k)   // byte by byte: matches may overlap
+                op[k] = match[k];
+            op += length;
+        }
+        if(op != oend)
+            throw runtime_error("LzBlockCodec: size mismatch");
+        return out;
+    }
+};